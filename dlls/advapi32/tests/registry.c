@@ -1661,6 +1661,82 @@ static void test_reg_load_key(void)
     delete_dir(saved_key);
 }
 
+static void test_reg_restore_key(void)
+{
+    char saved_key[2 * MAX_PATH], buf[16], *p;
+    HKEY src, dst, subkey;
+    DWORD ret, size;
+
+    if (!set_privileges(SE_RESTORE_NAME, TRUE) ||
+        !set_privileges(SE_BACKUP_NAME, TRUE))
+    {
+        win_skip("Failed to set SE_RESTORE_NAME privileges, skipping tests\n");
+        return;
+    }
+
+    GetTempPathA(MAX_PATH, saved_key);
+    strcat(saved_key, "\\wine_reg_test");
+    CreateDirectoryA(saved_key, NULL);
+    strcat(saved_key, "\\restore_key");
+
+    ret = RegCreateKeyA(hkey_main, "restore_src", &src);
+    ok(ret == ERROR_SUCCESS, "expected ERROR_SUCCESS, got %ld\n", ret);
+    ret = RegSetValueExA(src, "test", 0, REG_SZ, (BYTE *)"value", 6);
+    ok(ret == ERROR_SUCCESS, "expected ERROR_SUCCESS, got %ld\n", ret);
+    ret = RegCreateKeyA(src, "subkey", &subkey);
+    ok(ret == ERROR_SUCCESS, "expected ERROR_SUCCESS, got %ld\n", ret);
+    RegCloseKey(subkey);
+
+    ret = RegSaveKeyA(src, saved_key, NULL);
+    ok(ret == ERROR_SUCCESS, "expected ERROR_SUCCESS, got %ld\n", ret);
+
+    ret = RegCreateKeyA(hkey_main, "restore_dst", &dst);
+    ok(ret == ERROR_SUCCESS, "expected ERROR_SUCCESS, got %ld\n", ret);
+    ret = RegSetValueExA(dst, "stale", 0, REG_SZ, (BYTE *)"value", 6);
+    ok(ret == ERROR_SUCCESS, "expected ERROR_SUCCESS, got %ld\n", ret);
+    ret = RegCreateKeyA(dst, "stale_subkey", &subkey);
+    ok(ret == ERROR_SUCCESS, "expected ERROR_SUCCESS, got %ld\n", ret);
+    RegCloseKey(subkey);
+
+    ret = RegRestoreKeyA(dst, "", 0);
+    ok(ret == ERROR_INVALID_PARAMETER, "expected ERROR_INVALID_PARAMETER, got %ld\n", ret);
+
+    ret = RegRestoreKeyA(dst, saved_key, 0);
+    ok(ret == ERROR_SUCCESS, "expected ERROR_SUCCESS, got %ld\n", ret);
+
+    size = sizeof(buf);
+    ret = RegGetValueA(dst, NULL, "test", RRF_RT_REG_SZ, NULL, buf, &size);
+    ok(ret == ERROR_SUCCESS, "expected ERROR_SUCCESS, got %ld\n", ret);
+    if (ret == ERROR_SUCCESS)
+    {
+        ok(size == 6, "size = %ld\n", size);
+        ok(!strcmp(buf, "value"), "buf = %s\n", buf);
+    }
+
+    ret = RegOpenKeyA(dst, "subkey", &subkey);
+    ok(ret == ERROR_SUCCESS, "expected ERROR_SUCCESS, got %ld\n", ret);
+    if (ret == ERROR_SUCCESS) RegCloseKey(subkey);
+
+    /* the previous contents of the key are replaced */
+    ret = RegQueryValueExA(dst, "stale", NULL, NULL, NULL, NULL);
+    ok(ret == ERROR_FILE_NOT_FOUND, "expected ERROR_FILE_NOT_FOUND, got %ld\n", ret);
+    ret = RegOpenKeyA(dst, "stale_subkey", &subkey);
+    ok(ret == ERROR_FILE_NOT_FOUND, "expected ERROR_FILE_NOT_FOUND, got %ld\n", ret);
+    if (ret == ERROR_SUCCESS) RegCloseKey(subkey);
+
+    delete_key(dst);
+    RegCloseKey(dst);
+    delete_key(src);
+    RegCloseKey(src);
+
+    set_privileges(SE_RESTORE_NAME, FALSE);
+    set_privileges(SE_BACKUP_NAME, FALSE);
+
+    p = strrchr(saved_key, '\\');
+    *p = 0;
+    delete_dir(saved_key);
+}
+
 /* Helper function to wait for a file blocked by the registry to be available */
 static void wait_file_available(char *path)
 {
@@ -5181,6 +5257,7 @@ START_TEST(registry)
     test_classesroot_enum();
     test_classesroot_mask();
     test_reg_load_key();
+    test_reg_restore_key();
     test_reg_load_app_key();
     test_reg_copy_tree();
     test_reg_delete_tree();
@@ -6000,13 +6000,36 @@ static void test_GetFileAttributesExW(void)
     }
 }
 
+static DWORD WINAPI completion_burst_thread( void *arg )
+{
+    OVERLAPPED_ENTRY entries[16];
+    ULONG count, total = 0, i;
+    HANDLE port = arg;
+    BOOL ret;
+
+    /* a burst posted while we wait may be returned by a single wakeup */
+    while (total < ARRAY_SIZE(entries))
+    {
+        count = 0xdeadbeef;
+        ret = pGetQueuedCompletionStatusEx( port, entries, ARRAY_SIZE(entries) - total, &count, 5000, FALSE );
+        ok(ret, "GetQueuedCompletionStatusEx failed: %lu\n", GetLastError());
+        if (!ret) break;
+        ok(count && count <= ARRAY_SIZE(entries) - total, "wrong count %lu\n", count);
+        for (i = 0; i < count; i++)
+            ok(entries[i].lpCompletionKey == 2000 + total + i, "%lu: wrong key %Iu\n",
+               total + i, entries[i].lpCompletionKey);
+        total += count;
+    }
+    return total;
+}
+
 static void test_post_completion(void)
 {
     OVERLAPPED ovl, ovl2, *povl;
-    OVERLAPPED_ENTRY entries[2];
+    OVERLAPPED_ENTRY entries[2], many_entries[150];
     ULONG_PTR key;
-    HANDLE port;
-    ULONG count;
+    HANDLE port, thread;
+    ULONG count, i;
     DWORD size;
     BOOL ret;
 
@@ -6076,6 +6099,41 @@ static void test_post_completion(void)
     ok(!(ULONG)entries[1].Internal, "wrong internal %#lx\n", (ULONG)entries[1].Internal);
     ok(entries[1].dwNumberOfBytesTransferred == 654, "wrong size %lu\n", entries[1].dwNumberOfBytesTransferred);
 
+    for (i = 0; i < 200; i++)
+    {
+        ret = PostQueuedCompletionStatus( port, i, 1000 + i, &ovl );
+        ok(ret, "PostQueuedCompletionStatus failed: %lu\n", GetLastError());
+    }
+
+    count = 0xdeadbeef;
+    ret = pGetQueuedCompletionStatusEx( port, many_entries, 150, &count, 0, FALSE );
+    ok(ret, "GetQueuedCompletionStatusEx failed\n");
+    ok(count == 150, "wrong count %lu\n", count);
+    for (i = 0; i < count; i++)
+    {
+        ok(many_entries[i].lpCompletionKey == 1000 + i, "%lu: wrong key %Iu\n", i, many_entries[i].lpCompletionKey);
+        ok(many_entries[i].dwNumberOfBytesTransferred == i, "%lu: wrong size %lu\n", i, many_entries[i].dwNumberOfBytesTransferred);
+    }
+
+    count = 0xdeadbeef;
+    ret = pGetQueuedCompletionStatusEx( port, many_entries, 150, &count, 0, FALSE );
+    ok(ret, "GetQueuedCompletionStatusEx failed\n");
+    ok(count == 50, "wrong count %lu\n", count);
+    for (i = 0; i < count; i++)
+        ok(many_entries[i].lpCompletionKey == 1150 + i, "%lu: wrong key %Iu\n", i, many_entries[i].lpCompletionKey);
+
+    thread = CreateThread( NULL, 0, completion_burst_thread, port, 0, NULL );
+    for (i = 0; i < 16; i++)
+    {
+        ret = PostQueuedCompletionStatus( port, i, 2000 + i, &ovl );
+        ok(ret, "PostQueuedCompletionStatus failed: %lu\n", GetLastError());
+    }
+    ret = WaitForSingleObject( thread, 10000 );
+    ok(!ret, "wait failed\n");
+    GetExitCodeThread( thread, &size );
+    ok(size == 16, "got %lu completions\n", size);
+    CloseHandle( thread );
+
     user_apc_ran = FALSE;
     QueueUserAPC( user_apc, GetCurrentThread(), 0 );
 
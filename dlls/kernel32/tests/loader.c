@@ -2143,10 +2143,19 @@ static void test_import_resolution(void)
             IMAGE_BASE_RELOCATION reloc;
             USHORT type_off[32];
         } rel;
+        struct
+        {
+            IMAGE_BOUND_IMPORT_DESCRIPTOR descr;
+            IMAGE_BOUND_FORWARDER_REF fwd;
+            IMAGE_BOUND_IMPORT_DESCRIPTOR end;
+            char module[16];
+            char fwd_module[16];
+        } bound;
     } data, *ptr;
     IMAGE_NT_HEADERS nt, *pnt;
     IMAGE_SECTION_HEADER section;
     SECTION_IMAGE_INFORMATION image;
+    DWORD kernel32_timestamp, kernelbase_timestamp;
     int test, tls_index_save, nb_rel;
 #if defined(__i386__)
     static const UCHAR tls_init_code[] = {
@@ -2178,7 +2187,10 @@ static void test_import_resolution(void)
     static const UCHAR entry_point_code[] = { 0x00 };
 #endif
 
-    for (test = 0; test < 8; test++)
+    kernel32_timestamp = pRtlImageNtHeader( GetModuleHandleA( "kernel32.dll" ))->FileHeader.TimeDateStamp;
+    kernelbase_timestamp = pRtlImageNtHeader( GetModuleHandleA( "kernelbase.dll" ))->FileHeader.TimeDateStamp;
+
+    for (test = 0; test < 10; test++)
     {
 #define DATA_RVA(ptr) (page_size + ((char *)(ptr) - (char *)&data))
 #ifdef _WIN64
@@ -2241,6 +2253,28 @@ static void test_import_resolution(void)
             nt.OptionalHeader.AddressOfEntryPoint = DATA_RVA(&data.entry_point_fn);
         }
 
+        if (test == 8)  /* new style binding, with a forwarder */
+        {
+            data.descr[0].TimeDateStamp = ~0u;
+            data.descr[0].ForwarderChain = ~0u;
+            data.thunks[0].u1.Function = (ULONG_PTR)GetProcAddress( GetModuleHandleA( data.module ),
+                                                                    data.function.name );
+            strcpy( data.bound.module, data.module );
+            strcpy( data.bound.fwd_module, "kernelbase.dll" );
+            data.bound.descr.TimeDateStamp = kernel32_timestamp;
+            data.bound.descr.OffsetModuleName = (char *)data.bound.module - (char *)&data.bound;
+            data.bound.descr.NumberOfModuleForwarderRefs = 1;
+            data.bound.fwd.TimeDateStamp = kernelbase_timestamp;
+            data.bound.fwd.OffsetModuleName = (char *)data.bound.fwd_module - (char *)&data.bound;
+            nt.OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_BOUND_IMPORT].Size = sizeof(data.bound);
+            nt.OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_BOUND_IMPORT].VirtualAddress = DATA_RVA(&data.bound);
+        }
+        else if (test == 9)  /* old style binding with a stale timestamp */
+        {
+            data.descr[0].TimeDateStamp = kernel32_timestamp + 1;
+            data.descr[0].ForwarderChain = ~0u;
+        }
+
         if (nb_rel % 2) nb_rel++;
         data.rel.reloc.VirtualAddress = nt.OptionalHeader.SectionAlignment;
         data.rel.reloc.SizeOfBlock = (char *)&data.rel.type_off[nb_rel] - (char *)&data.rel.reloc;
@@ -2274,6 +2308,8 @@ static void test_import_resolution(void)
         switch (test)
         {
         case 0:  /* normal load */
+        case 8:  /* load with valid bound imports */
+        case 9:  /* load with stale bound imports */
             mod = LoadLibraryW( dll_name );
             ok( mod != NULL, "failed to load err %lu\n", GetLastError() );
             if (!mod) break;
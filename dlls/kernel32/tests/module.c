@@ -1356,6 +1356,72 @@ static void test_AddDllDirectory(void)
     ok( GetLastError() == ERROR_INVALID_PARAMETER, "wrong error %lu\n", GetLastError() );
 }
 
+static void test_dll_search_changes(void)
+{
+    char path[MAX_PATH], dir[MAX_PATH], dll[MAX_PATH];
+    HMODULE mod;
+    BOOL ret;
+
+    if (!pSetDllDirectoryA)
+    {
+        win_skip( "SetDllDirectoryA not available\n" );
+        return;
+    }
+
+    GetTempPathA( sizeof(path), path );
+    GetTempFileNameA( path, "tmp", 0, dir );
+    DeleteFileA( dir );
+    ret = CreateDirectoryA( dir, NULL );
+    ok( ret, "CreateDirectory failed err %lu\n", GetLastError() );
+    sprintf( dll, "%s\\winetestsearch.dll", dir );
+    pSetDllDirectoryA( dir );
+
+    /* a dll that wasn't found must be found once it's created */
+    SetLastError( 0xdeadbeef );
+    mod = LoadLibraryA( "winetestsearch.dll" );
+    ok( !mod, "LoadLibrary succeeded\n" );
+    ok( GetLastError() == ERROR_MOD_NOT_FOUND, "wrong error %lu\n", GetLastError() );
+
+    create_test_dll( dll );
+    mod = LoadLibraryA( "winetestsearch.dll" );
+    ok( mod != NULL, "LoadLibrary failed err %lu\n", GetLastError() );
+    FreeLibrary( mod );
+
+    /* and not found anymore once it's deleted */
+    ret = DeleteFileA( dll );
+    ok( ret, "DeleteFile failed err %lu\n", GetLastError() );
+    SetLastError( 0xdeadbeef );
+    mod = LoadLibraryA( "winetestsearch.dll" );
+    ok( !mod, "LoadLibrary succeeded\n" );
+    ok( GetLastError() == ERROR_MOD_NOT_FOUND, "wrong error %lu\n", GetLastError() );
+
+    /* the same goes for a dll in a directory that didn't exist yet */
+    strcat( dir, "\\sub" );
+    sprintf( dll, "%s\\winetestsearch.dll", dir );
+    pSetDllDirectoryA( dir );
+    SetLastError( 0xdeadbeef );
+    mod = LoadLibraryA( "winetestsearch.dll" );
+    ok( !mod, "LoadLibrary succeeded\n" );
+    ok( GetLastError() == ERROR_MOD_NOT_FOUND, "wrong error %lu\n", GetLastError() );
+
+    ret = CreateDirectoryA( dir, NULL );
+    ok( ret, "CreateDirectory failed err %lu\n", GetLastError() );
+    create_test_dll( dll );
+    mod = LoadLibraryA( "winetestsearch.dll" );
+    ok( mod != NULL, "LoadLibrary failed err %lu\n", GetLastError() );
+    FreeLibrary( mod );
+
+    pSetDllDirectoryA( NULL );
+    ret = DeleteFileA( dll );
+    ok( ret, "DeleteFile failed err %lu\n", GetLastError() );
+    /* the loader must not keep the searched directories open */
+    ret = RemoveDirectoryA( dir );
+    ok( ret, "RemoveDirectory failed err %lu\n", GetLastError() );
+    *strrchr( dir, '\\' ) = 0;
+    ret = RemoveDirectoryA( dir );
+    ok( ret, "RemoveDirectory failed err %lu\n", GetLastError() );
+}
+
 static void test_SetDefaultDllDirectories(void)
 {
     HMODULE mod;
@@ -2108,6 +2174,7 @@ START_TEST(module)
     testK32GetModuleInformation();
     test_AddDllDirectory();
     test_SetDefaultDllDirectories();
+    test_dll_search_changes();
     test_LdrGetDllHandleEx();
     test_LdrGetDllFullName();
     test_apisets();
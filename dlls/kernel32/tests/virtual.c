@@ -1306,6 +1306,10 @@ static void test_MapViewOfFile(void)
     ok( status == STATUS_SECTION_NOT_IMAGE, "NtQuerySection failed err %lx\n", status );
     status = pNtQuerySection( mapping, SectionImageInformation, &image_info, sizeof(image_info)+1, NULL );
     ok( status == STATUS_SECTION_NOT_IMAGE, "NtQuerySection failed err %lx\n", status );
+    status = pNtQuerySection( mapping, SectionOriginalBaseInformation, &ptr, sizeof(ptr)-1, NULL );
+    ok( status == STATUS_INFO_LENGTH_MISMATCH, "NtQuerySection failed err %lx\n", status );
+    status = pNtQuerySection( mapping, SectionOriginalBaseInformation, &ptr, sizeof(ptr), NULL );
+    ok( status == STATUS_SECTION_NOT_IMAGE, "NtQuerySection failed err %lx\n", status );
     if (sizeof(SIZE_T) > sizeof(int))
     {
         status = pNtQuerySection( mapping, SectionImageInformation, &image_info,
@@ -106,6 +106,51 @@ static inline BOOL bnum_rshift(struct bnum *b, int shift)
     return ret;
 }
 
+/* Stores m*2^e2 in b when it can be converted exactly with 64-bit arithmetic.
+ * The limbs are laid out the same way bnum_lshift and bnum_rshift leave them,
+ * so callers can use it as a fast path. Returns decimal exponent in e10. */
+static inline BOOL bnum_from_mant(struct bnum *b, ULONGLONG m, int e2, int *e10)
+{
+    ULONGLONG x, f = 0, mask = 0;
+    int i, n, k = 0, d = LIMB_DIGITS;
+    DWORD l;
+
+    if(e2 >= 0) {
+        if(e2 > 64 - MANT_BITS) return FALSE;
+        x = m << e2;
+    } else {
+        k = -e2;
+        /* keep at least one decimal digit of headroom for the fraction */
+        if(k > 60) return FALSE;
+        mask = ((ULONGLONG)1 << k) - 1;
+        x = m >> k;
+        f = m & mask;
+        while(d > 1 && k > 34 && p10s[d] > ((ULONGLONG)1 << (64 - k))) d--;
+    }
+
+    b->b = b->e = 0;
+    b->size = BNUM_PREC64;
+    while(x) {
+        b->data[bnum_idx(b, b->e++)] = x % LIMB_MAX;
+        x /= LIMB_MAX;
+    }
+
+    while(f) {
+        l = 0;
+        for(n = LIMB_DIGITS; n > 0; n -= i) {
+            i = n < d ? n : d;
+            f *= p10s[i];
+            l = l * p10s[i] + (f >> k);
+            f &= mask;
+        }
+        b->data[bnum_idx(b, --b->b)] = l;
+    }
+
+    while(!b->data[bnum_idx(b, b->e - 1)]) b->e--;
+    *e10 = LIMB_DIGITS * (b->e - 2);
+    return TRUE;
+}
+
 static inline void bnum_mult(struct bnum *b, int mult)
 {
     DWORD rest = 0;
@@ -3912,19 +3912,35 @@ char * CDECL fgets(char *s, int size, FILE* file)
 
   _lock_file(file);
 
-  while ((size >1) && (cc = _fgetc_nolock(file)) != EOF && cc != '\n')
+  while (size > 1)
+  {
+    if (file->_cnt > 0)
     {
-      *s++ = (char)cc;
-      size --;
+      /* copy directly from the stream buffer up to and including the newline */
+      int len = min(file->_cnt, size - 1);
+      char *nl = memchr(file->_ptr, '\n', len);
+
+      if (nl) len = nl - file->_ptr + 1;
+      memcpy(s, file->_ptr, len);
+      file->_ptr += len;
+      file->_cnt -= len;
+      s += len;
+      size -= len;
+      if (nl) break;
+      continue;
     }
+
+    if ((cc = _fgetc_nolock(file)) == EOF) break;
+    *s++ = (char)cc;
+    size--;
+    if (cc == '\n') break;
+  }
   if ((cc == EOF) && (s == buf_start)) /* If nothing read, return 0*/
   {
     TRACE(":nothing read\n");
     _unlock_file(file);
     return NULL;
   }
-  if ((cc != EOF) && (size > 1))
-    *s++ = cc;
   *s = '\0';
   TRACE(":got %s\n", debugstr_a(buf_start));
   _unlock_file(file);
@@ -24,6 +24,7 @@
 #include <malloc.h>
 #include "msvcrt.h"
 #include "mtdll.h"
+#include "wine/list.h"
 #include "wine/debug.h"
 
 WINE_DEFAULT_DEBUG_CHANNEL(msvcrt);
@@ -41,7 +42,49 @@ WINE_DEFAULT_DEBUG_CHANNEL(msvcrt);
 
 #define SB_HEAP_ALIGN 16
 
+/* small blocks are rounded up to a size class so that they can be cached per thread */
+#define SB_HEAP_CLASS(size)  (((size) + SB_HEAP_ALIGN - 1) / SB_HEAP_ALIGN)
+#define SB_HEAP_CLASSES      (SB_HEAP_CLASS(SB_HEAP_MAX_THRESHOLD) + 1)
+#define SB_HEAP_CACHE_DEPTH  8
+#define SB_HEAP_FREE         ~0u
+#define SB_HEAP_MAX_THRESHOLD 1016
+/* the small block heap can't grow, so that its blocks can be recognized by their address */
+#ifdef _WIN64
+#define SB_HEAP_SIZE         (256 * 1024 * 1024)
+#else
+#define SB_HEAP_SIZE         (32 * 1024 * 1024)
+#endif
+
 static HANDLE heap, sb_heap;
+static const char *sb_heap_start, *sb_heap_end;
+static DWORD sb_heap_cache_tls = TLS_OUT_OF_INDEXES;
+static struct list sb_heap_caches = LIST_INIT(sb_heap_caches);
+
+static CRITICAL_SECTION sb_heap_cs;
+static CRITICAL_SECTION_DEBUG sb_heap_cs_debug =
+{
+    0, 0, &sb_heap_cs,
+    { &sb_heap_cs_debug.ProcessLocksList, &sb_heap_cs_debug.ProcessLocksList },
+      0, 0, { (DWORD_PTR)(__FILE__ ": sb_heap_cs") }
+};
+static CRITICAL_SECTION sb_heap_cs = { &sb_heap_cs_debug, -1, 0, 0, 0, 0 };
+
+/* stored right before every small block heap allocation */
+struct sb_header
+{
+    DWORD size;    /* requested size, SB_HEAP_FREE once the block is freed */
+    WORD  class;   /* size class */
+    WORD  offset;  /* offset of the block from the heap allocation */
+};
+
+/* freed small blocks of a thread, sb_heap_cs protects the list and other threads' access */
+struct sb_heap_cache
+{
+    struct list entry;
+    SRWLOCK lock;
+    unsigned int count[SB_HEAP_CLASSES];
+    void *blocks[SB_HEAP_CLASSES][SB_HEAP_CACHE_DEPTH];
+};
 
 typedef int (CDECL *MSVCRT_new_handler_func)(size_t size);
 
@@ -53,73 +96,216 @@ static unsigned int MSVCRT_amblksiz = 16;
 /* FIXME - According to documentation it should be 480 bytes, at runtime default is 0 */
 static size_t MSVCRT_sbh_threshold = 0;
 
-static void* msvcrt_heap_alloc(DWORD flags, size_t size)
+static inline struct sb_header *sb_header_from_ptr(void *ptr)
 {
-    if(size < MSVCRT_sbh_threshold)
-    {
-        void *memblock, *temp, **saved;
+    return (struct sb_header *)ptr - 1;
+}
 
-        temp = HeapAlloc(sb_heap, flags, size+sizeof(void*)+SB_HEAP_ALIGN);
-        if(!temp) return NULL;
+static inline void *sb_base_from_ptr(void *ptr)
+{
+    return (char *)ptr - sb_header_from_ptr(ptr)->offset;
+}
 
-        memblock = ALIGN_PTR(temp, SB_HEAP_ALIGN, 0);
-        saved = SAVED_PTR(memblock);
-        *saved = temp;
-        return memblock;
+static inline BOOL sb_heap_owns_ptr(void *ptr)
+{
+    return (const char *)ptr >= sb_heap_start && (const char *)ptr < sb_heap_end;
+}
+
+static BOOL sb_heap_init(void)
+{
+    PROCESS_HEAP_ENTRY entry;
+
+    if(sb_heap) return TRUE;
+    if(sb_heap_cache_tls == TLS_OUT_OF_INDEXES &&
+            (sb_heap_cache_tls = TlsAlloc()) == TLS_OUT_OF_INDEXES)
+        return FALSE;
+    if(!(sb_heap = HeapCreate(0, 0, SB_HEAP_SIZE)))
+        return FALSE;
+
+    /* a fixed size heap is made of a single region */
+    entry.lpData = NULL;
+    while(HeapWalk(sb_heap, &entry))
+    {
+        if(!(entry.wFlags & PROCESS_HEAP_REGION)) continue;
+        sb_heap_start = entry.Region.lpFirstBlock;
+        sb_heap_end = entry.Region.lpLastBlock;
+        break;
+    }
+    if(!sb_heap_end)
+    {
+        HeapDestroy(sb_heap);
+        sb_heap = NULL;
+        return FALSE;
     }
+    return TRUE;
+}
 
-    return HeapAlloc(heap, flags, size);
+static struct sb_heap_cache *sb_heap_get_cache(void)
+{
+    struct sb_heap_cache *cache = TlsGetValue(sb_heap_cache_tls);
+
+    if(!cache && (cache = HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, sizeof(*cache))))
+    {
+        InitializeSRWLock(&cache->lock);
+        EnterCriticalSection(&sb_heap_cs);
+        list_add_tail(&sb_heap_caches, &cache->entry);
+        LeaveCriticalSection(&sb_heap_cs);
+        TlsSetValue(sb_heap_cache_tls, cache);
+    }
+    return cache;
 }
 
-static void* msvcrt_heap_realloc(DWORD flags, void *ptr, size_t size)
+/* must be called with the cache lock held */
+static void sb_heap_flush_cache(struct sb_heap_cache *cache)
 {
-    if(sb_heap && ptr && !HeapValidate(heap, 0, ptr))
+    unsigned int i;
+
+    for(i = 0; i < SB_HEAP_CLASSES; i++)
     {
-        /* TODO: move data to normal heap if it exceeds sbh_threshold limit */
-        void *memblock, *temp, **saved;
-        size_t old_padding, new_padding, old_size;
+        while(cache->count[i])
+            HeapFree(sb_heap, 0, sb_base_from_ptr(cache->blocks[i][--cache->count[i]]));
+    }
+}
 
-        saved = SAVED_PTR(ptr);
-        old_padding = (char*)ptr - (char*)*saved;
-        old_size = HeapSize(sb_heap, 0, *saved);
-        if(old_size == -1)
-            return NULL;
-        old_size -= old_padding;
+/* release the blocks cached by every thread, so that the heap functions see them as free */
+static void sb_heap_flush_caches(void)
+{
+    struct sb_heap_cache *cache;
 
-        temp = HeapReAlloc(sb_heap, flags, *saved, size+sizeof(void*)+SB_HEAP_ALIGN);
-        if(!temp) return NULL;
+    if(!sb_heap) return;
 
-        memblock = ALIGN_PTR(temp, SB_HEAP_ALIGN, 0);
-        saved = SAVED_PTR(memblock);
-        new_padding = (char*)memblock - (char*)temp;
+    EnterCriticalSection(&sb_heap_cs);
+    LIST_FOR_EACH_ENTRY(cache, &sb_heap_caches, struct sb_heap_cache, entry)
+    {
+        AcquireSRWLockExclusive(&cache->lock);
+        sb_heap_flush_cache(cache);
+        ReleaseSRWLockExclusive(&cache->lock);
+    }
+    LeaveCriticalSection(&sb_heap_cs);
+}
 
-        if(new_padding != old_padding)
-            memmove(memblock, (char*)temp+old_padding, old_size>size ? size : old_size);
+static void* sb_heap_alloc(DWORD flags, size_t size)
+{
+    struct sb_heap_cache *cache = sb_heap_get_cache();
+    unsigned int class = SB_HEAP_CLASS(size);
+    struct sb_header *header;
+    void *memblock = NULL;
+    char *temp;
 
-        *saved = temp;
+    if(cache)
+    {
+        AcquireSRWLockExclusive(&cache->lock);
+        if(cache->count[class])
+            memblock = cache->blocks[class][--cache->count[class]];
+        ReleaseSRWLockExclusive(&cache->lock);
+    }
+    if(memblock)
+    {
+        sb_header_from_ptr(memblock)->size = size;
+        if(flags & HEAP_ZERO_MEMORY) memset(memblock, 0, size);
         return memblock;
     }
 
-    return HeapReAlloc(heap, flags, ptr, size);
+    temp = HeapAlloc(sb_heap, flags, class*SB_HEAP_ALIGN+sizeof(*header)+SB_HEAP_ALIGN-1);
+    /* the small block heap is full */
+    if(!temp) return HeapAlloc(heap, flags, size);
+
+    memblock = (void*)(((DWORD_PTR)temp + sizeof(*header) + SB_HEAP_ALIGN - 1) & ~(SB_HEAP_ALIGN - 1));
+    header = sb_header_from_ptr(memblock);
+    header->size = size;
+    header->class = class;
+    header->offset = (char*)memblock - temp;
+    return memblock;
 }
 
-static BOOL msvcrt_heap_free(void *ptr)
+static BOOL sb_heap_free(void *ptr)
 {
-    if(sb_heap && ptr && !HeapValidate(heap, 0, ptr))
+    struct sb_header *header = sb_header_from_ptr(ptr);
+    struct sb_heap_cache *cache;
+    BOOL cached = FALSE;
+
+    if(header->size == SB_HEAP_FREE)
     {
-        void **saved = SAVED_PTR(ptr);
-        return HeapFree(sb_heap, 0, *saved);
+        WARN("block %p already freed\n", ptr);
+        return FALSE;
     }
+    header->size = SB_HEAP_FREE;
+
+    if((cache = sb_heap_get_cache()))
+    {
+        AcquireSRWLockExclusive(&cache->lock);
+        if(cache->count[header->class] < SB_HEAP_CACHE_DEPTH)
+        {
+            cache->blocks[header->class][cache->count[header->class]++] = ptr;
+            cached = TRUE;
+        }
+        ReleaseSRWLockExclusive(&cache->lock);
+    }
+    return cached || HeapFree(sb_heap, 0, sb_base_from_ptr(ptr));
+}
+
+static void* sb_heap_realloc(DWORD flags, void *ptr, size_t size)
+{
+    struct sb_header *header = sb_header_from_ptr(ptr);
+    void *memblock;
+
+    if(header->size == SB_HEAP_FREE)
+    {
+        WARN("block %p already freed\n", ptr);
+        return NULL;
+    }
+
+    /* the block is large enough for its whole size class */
+    if(size <= header->class*SB_HEAP_ALIGN)
+    {
+        if((flags & HEAP_ZERO_MEMORY) && size > header->size)
+            memset((char*)ptr + header->size, 0, size - header->size);
+        header->size = size;
+        return ptr;
+    }
+    if(flags & HEAP_REALLOC_IN_PLACE_ONLY) return NULL;
+
+    if(size < MSVCRT_sbh_threshold)
+        memblock = sb_heap_alloc(flags, size);
+    else
+        memblock = HeapAlloc(heap, flags, size);
+    if(!memblock) return NULL;
+
+    memcpy(memblock, ptr, header->size);
+    sb_heap_free(ptr);
+    return memblock;
+}
+
+static void* msvcrt_heap_alloc(DWORD flags, size_t size)
+{
+    if(size < MSVCRT_sbh_threshold)
+        return sb_heap_alloc(flags, size);
+
+    return HeapAlloc(heap, flags, size);
+}
+
+static void* msvcrt_heap_realloc(DWORD flags, void *ptr, size_t size)
+{
+    if(sb_heap_owns_ptr(ptr))
+        return sb_heap_realloc(flags, ptr, size);
+
+    return HeapReAlloc(heap, flags, ptr, size);
+}
+
+static BOOL msvcrt_heap_free(void *ptr)
+{
+    if(sb_heap_owns_ptr(ptr))
+        return sb_heap_free(ptr);
 
     return HeapFree(heap, 0, ptr);
 }
 
 static size_t msvcrt_heap_size(void *ptr)
 {
-    if(sb_heap && ptr && !HeapValidate(heap, 0, ptr))
+    if(sb_heap_owns_ptr(ptr))
     {
-        void **saved = SAVED_PTR(ptr);
-        return HeapSize(sb_heap, 0, *saved);
+        DWORD size = sb_header_from_ptr(ptr)->size;
+        return size == SB_HEAP_FREE ? -1 : size;
     }
 
     return HeapSize(heap, 0, ptr);
@@ -257,6 +443,8 @@ int CDECL _heapchk(void)
  */
 int CDECL _heapmin(void)
 {
+  sb_heap_flush_caches();
+
   if (!HeapCompact( heap, 0 ) ||
           (sb_heap && !HeapCompact( sb_heap, 0 )))
   {
@@ -277,6 +465,10 @@ int CDECL _heapwalk(_HEAPINFO *next)
   if (sb_heap)
       FIXME("small blocks heap not supported\n");
 
+  /* blocks cached by other threads must not be reported as used */
+  if (!next->_pentry)
+      sb_heap_flush_caches();
+
   LOCK_HEAP;
   phe.lpData = next->_pentry;
   phe.cbData = next->_size;
@@ -525,15 +717,11 @@ int CDECL _set_sbh_threshold(size_t threshold)
 #ifdef _WIN64
   return 0;
 #else
-  if(threshold > 1016)
+  if(threshold > SB_HEAP_MAX_THRESHOLD)
      return 0;
 
-  if(!sb_heap)
-  {
-      sb_heap = HeapCreate(0, 0, 0);
-      if(!sb_heap)
-          return 0;
-  }
+  if(!sb_heap_init())
+      return 0;
 
   MSVCRT_sbh_threshold = (threshold+0xf) & ~0xf;
   return 1;
@@ -829,16 +1017,48 @@ int CDECL wmemcpy_s(wchar_t *dest, size_t numberOfElements,
 
 BOOL msvcrt_init_heap(void)
 {
+    char select[64];
+    DWORD len;
+
 #if _MSVCR_VER <= 100
     heap = HeapCreate(0, 0, 0);
 #else
     heap = GetProcessHeap();
 #endif
-    return heap != NULL;
+    if(!heap) return FALSE;
+
+    /* Selecting the V6 heap enables the small block heap and its per-thread caches for all
+     * versions. It's opt-in because the small blocks can't be freed with HeapFree. */
+    len = GetEnvironmentVariableA("__MSVCRT_HEAP_SELECT", select, sizeof(select));
+    if(len && len < sizeof(select) && !strcmp(select, "__GLOBAL_HEAP_SELECTED,3") && sb_heap_init())
+    {
+        TRACE("using the small block heap\n");
+        MSVCRT_sbh_threshold = (SB_HEAP_MAX_THRESHOLD+0xf) & ~0xf;
+    }
+    return TRUE;
+}
+
+void msvcrt_free_heap_cache(void)
+{
+    struct sb_heap_cache *cache;
+
+    if(sb_heap_cache_tls == TLS_OUT_OF_INDEXES) return;
+    if(!(cache = TlsGetValue(sb_heap_cache_tls))) return;
+
+    EnterCriticalSection(&sb_heap_cs);
+    list_remove(&cache->entry);
+    LeaveCriticalSection(&sb_heap_cs);
+
+    sb_heap_flush_cache(cache);
+    TlsSetValue(sb_heap_cache_tls, NULL);
+    HeapFree(GetProcessHeap(), 0, cache);
 }
 
 void msvcrt_destroy_heap(void)
 {
+    msvcrt_free_heap_cache();
+    if(sb_heap_cache_tls != TLS_OUT_OF_INDEXES)
+        TlsFree(sb_heap_cache_tls);
 #if _MSVCR_VER <= 100
     HeapDestroy(heap);
 #endif
@@ -169,14 +169,19 @@ int CDECL _set_SSE2_enable(int flag)
 }
 
 #if defined(_WIN64)
+/* selection of the fma variants in musl, see libs/musl/src/math/__fma_supported.c */
+extern int __fma_enabled;
+extern int __fma_supported(void);
+extern int __fma_init(void);
+
 # if _MSVCR_VER>=140
 /*********************************************************************
  *      _get_FMA3_enable (UCRTBASE.@)
  */
 int CDECL _get_FMA3_enable(void)
 {
-    FIXME("() stub\n");
-    return 0;
+    if (__fma_enabled < 0) return __fma_init();
+    return __fma_enabled;
 }
 # endif
 
@@ -186,8 +191,8 @@ int CDECL _get_FMA3_enable(void)
  */
 int CDECL _set_FMA3_enable(int flag)
 {
-    FIXME("(%x) stub\n", flag);
-    return 0;
+    __fma_enabled = flag && __fma_supported();
+    return __fma_enabled;
 }
 # endif
 #endif
@@ -272,6 +272,7 @@ extern void msvcrt_free_signals(void);
 extern void msvcrt_free_popen_data(void);
 extern BOOL msvcrt_init_heap(void);
 extern void msvcrt_destroy_heap(void);
+extern void msvcrt_free_heap_cache(void);
 extern void msvcrt_init_clock(void);
 
 #if _MSVCR_VER >= 100
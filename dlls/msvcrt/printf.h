@@ -621,22 +621,25 @@ static inline int FUNC_NAME(pf_output_fp)(FUNC_NAME(puts_clbk) pf_puts, void *pu
     if(v) {
         m = (ULONGLONG)1 << (MANT_BITS - 1);
         m |= (*(ULONGLONG*)&v & (((ULONGLONG)1 << (MANT_BITS - 1)) - 1));
-        b->b = 0;
-        b->e = 2;
-        b->size = BNUM_PREC64;
-        b->data[0] = m % LIMB_MAX;
-        b->data[1] = m / LIMB_MAX;
         e2 -= MANT_BITS;
 
-        while(e2 > 0) {
-            int shift = e2 > 29 ? 29 : e2;
-            if(bnum_lshift(b, shift)) e10 += LIMB_DIGITS;
-            e2 -= shift;
-        }
-        while(e2 < 0) {
-            int shift = -e2 > 9 ? 9 : -e2;
-            if(bnum_rshift(b, shift)) e10 -= LIMB_DIGITS;
-            e2 += shift;
+        if(!bnum_from_mant(b, m, e2, &e10)) {
+            b->b = 0;
+            b->e = 2;
+            b->size = BNUM_PREC64;
+            b->data[0] = m % LIMB_MAX;
+            b->data[1] = m / LIMB_MAX;
+
+            while(e2 > 0) {
+                int shift = e2 > 29 ? 29 : e2;
+                if(bnum_lshift(b, shift)) e10 += LIMB_DIGITS;
+                e2 -= shift;
+            }
+            while(e2 < 0) {
+                int shift = -e2 > 9 ? 9 : -e2;
+                if(bnum_rshift(b, shift)) e10 -= LIMB_DIGITS;
+                e2 += shift;
+            }
         }
     } else {
         b->b = 0;
@@ -740,6 +740,58 @@ static inline BOOL bnum_to_mant(struct bnum *b, ULONGLONG *m)
     return TRUE;
 }
 
+/* Converts w*10^exp10 without going through bnum when it can be done
+ * exactly with 64-bit arithmetic. Return FALSE if the slow path is needed. */
+static BOOL fpnum_from_dec(int sign, ULONGLONG w, int exp10, struct fpnum *ret)
+{
+    ULONGLONG p5 = 1, num[2], q[2] = { 0 }, rem = 0, drop, half;
+    enum fpmod mod = FP_ROUND_ZERO;
+    int i, z = 0, sh;
+
+    if(exp10 >= 0) {
+        /* w*10^e == w*5^e*2^e, 5^27 is the largest power that fits */
+        if(exp10 > 27) return FALSE;
+        for(i=0; i<exp10; i++) p5 *= 5;
+        if(w > UI64_MAX / p5) return FALSE;
+        *ret = fpnum(sign, exp10, w * p5, FP_ROUND_ZERO);
+        return TRUE;
+    }
+
+    /* w*10^-k == w/5^k*2^-k, long division in 32-bit steps needs 5^k < 2^32 */
+    if(exp10 < -13) return FALSE;
+    for(i=0; i<-exp10; i++) p5 *= 5;
+
+    while(!(w >> 63)) {
+        w <<= 1;
+        z++;
+    }
+    num[0] = w;
+    num[1] = 0;
+    for(i=0; i<4; i++) {
+        ULONGLONG cur = (rem << 32) | (DWORD)(num[i / 2] >> (i % 2 ? 0 : 32));
+        q[i / 2] = (q[i / 2] << 32) | (cur / p5);
+        rem = cur % p5;
+    }
+
+    /* q[0] >= 2^32 here, keep its 64 most significant bits */
+    for(sh = 64; !(q[0] >> (sh - 1)); sh--);
+    if(sh == 64) {
+        drop = q[1];
+        q[1] = q[0];
+    } else {
+        drop = q[1] & (((ULONGLONG)1 << sh) - 1);
+        q[1] = (q[0] << (64 - sh)) | (q[1] >> sh);
+    }
+    half = (ULONGLONG)1 << (sh - 1);
+
+    if(drop > half || (drop == half && rem)) mod = FP_ROUND_UP;
+    else if(drop == half) mod = FP_ROUND_EVEN;
+    else if(drop || rem) mod = FP_ROUND_DOWN;
+
+    *ret = fpnum(sign, exp10 - 64 - z + sh, q[1], mod);
+    return TRUE;
+}
+
 static struct fpnum fpnum_parse_bnum(wchar_t (*get)(void *ctx), void (*unget)(void *ctx),
         void *ctx, pthreadlocinfo locinfo, BOOL ldouble, struct bnum *b)
 {
@@ -750,10 +802,11 @@ static struct fpnum fpnum_parse_bnum(wchar_t (*get)(void *ctx), void (*unget)(vo
     int matched=0;
 #endif
     BOOL found_digit = FALSE, found_dp = FALSE, found_sign = FALSE;
-    int e2 = 0, dp=0, sign=1, off, limb_digits = 0, i;
+    int e2 = 0, dp=0, sign=1, off, limb_digits = 0, i, nd = 0;
     enum fpmod round = FP_ROUND_ZERO;
+    struct fpnum ret;
     wchar_t nch;
-    ULONGLONG m;
+    ULONGLONG m, w = 0;
 
     nch = get(ctx);
     if(nch == '-') {
@@ -823,6 +876,7 @@ static struct fpnum fpnum_parse_bnum(wchar_t (*get)(void *ctx), void (*unget)(vo
         }
 
         b->data[bnum_idx(b, b->b)] = b->data[bnum_idx(b, b->b)] * 10 + nch - '0';
+        if(nd++ < 19) w = w * 10 + nch - '0';
         limb_digits++;
         nch = get(ctx);
         dp++;
@@ -859,6 +913,7 @@ static struct fpnum fpnum_parse_bnum(wchar_t (*get)(void *ctx), void (*unget)(vo
         }
 
         b->data[bnum_idx(b, b->b)] = b->data[bnum_idx(b, b->b)] * 10 + nch - '0';
+        if(nd++ < 19) w = w * 10 + nch - '0';
         limb_digits++;
         nch = get(ctx);
     }
@@ -915,6 +970,11 @@ static struct fpnum fpnum_parse_bnum(wchar_t (*get)(void *ctx), void (*unget)(vo
     if(!b->data[bnum_idx(b, b->e-1)])
         return fpnum(sign, 0, 0, 0);
 
+    /* all significant digits are in w, try the exact fast path first */
+    if(!ldouble && nd <= 19 && dp >= nd - 13 && dp <= nd + 27 &&
+            fpnum_from_dec(sign, w, dp - nd, &ret))
+        return ret;
+
     /* Fill last limb with 0 if needed */
     if(b->b+1 != b->e) {
         for(; limb_digits != LIMB_DIGITS; limb_digits++)
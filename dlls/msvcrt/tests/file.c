@@ -640,6 +640,47 @@ static void test_readboundary(void)
   ok(strcmp(buf, rbuf) == 0,"CRLF on buffer boundary failure\n");
   }
 
+static void test_fgets_lines(void)
+{
+  static const int lens[] = { 0, 1, 15, 510, 4094, 4095, 4096, 4097, 9000 };
+  char *line, *buf;
+  FILE *fp;
+  int i, j;
+
+  line = malloc(9002);
+  buf = malloc(9002);
+  fp = fopen("fgets.tst", "wb");
+  for (i = 0; i < ARRAY_SIZE(lens); i++)
+  {
+    for (j = 0; j < lens[i]; j++)
+      fputc('a' + (i + j) % 26, fp);
+    fputc('\n', fp);
+  }
+  fputs("tail", fp);
+  fclose(fp);
+
+  fp = fopen("fgets.tst", "rb");
+  for (i = 0; i < ARRAY_SIZE(lens); i++)
+  {
+    for (j = 0; j < lens[i]; j++)
+      line[j] = 'a' + (i + j) % 26;
+    line[j++] = '\n';
+    line[j] = 0;
+    ok(fgets(buf, 9002, fp) == buf, "%d: fgets failed\n", i);
+    ok(!strcmp(buf, line), "%d: got length %Iu, expected %d\n", i, strlen(buf), lens[i] + 1);
+  }
+  ok(fgets(buf, 3, fp) == buf, "fgets failed\n");
+  ok(!strcmp(buf, "ta"), "buf = %s\n", buf);
+  ok(fgets(buf, 9002, fp) == buf, "fgets failed\n");
+  ok(!strcmp(buf, "il"), "buf = %s\n", buf);
+  ok(feof(fp), "expected EOF\n");
+  ok(!fgets(buf, 9002, fp), "fgets succeeded at EOF\n");
+  fclose(fp);
+  unlink("fgets.tst");
+  free(line);
+  free(buf);
+}
+
 static void test_fgetc( void )
 {
   char* tempf;
@@ -3194,6 +3235,7 @@ START_TEST(file)
     test_readmode(FALSE); /* binary mode */
     test_readmode(TRUE);  /* ascii mode */
     test_readboundary();
+    test_fgets_lines();
     test_fgetc();
     test_fputc();
     test_flsbuf();
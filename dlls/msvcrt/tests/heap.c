@@ -459,6 +459,26 @@ static void test_sbheap(void)
     mem = realloc(mem, 10);
     ok(mem != NULL, "realloc failed\n");
     ok(!((UINT_PTR)mem & 0xf), "incorrect alignment (%p)\n", mem);
+    free(mem);
+
+    mem = malloc(40);
+    ok(mem != NULL, "malloc failed\n");
+    memset(mem, 0xcc, 40);
+    free(mem);
+    mem = calloc(1, 40);
+    ok(mem != NULL, "calloc failed\n");
+    ok(!((UINT_PTR)mem & 0xf), "incorrect alignment (%p)\n", mem);
+    ok(!((char*)mem)[0] && !((char*)mem)[39], "memory not zeroed\n");
+    ok(_msize(mem) >= 40, "_msize returned %d\n", (int)_msize(mem));
+
+    mem = realloc(mem, 100);
+    ok(mem != NULL, "realloc failed\n");
+    ok(!((char*)mem)[0] && !((char*)mem)[39], "memory not preserved\n");
+
+    mem = realloc(mem, 2000);
+    ok(mem != NULL, "realloc failed\n");
+    ok(!((char*)mem)[0] && !((char*)mem)[39], "memory not preserved\n");
+    ok(_msize(mem) == 2000, "_msize returned %d\n", (int)_msize(mem));
 
     ok(p__set_sbh_threshold(0), "_set_sbh_threshold failed\n");
     threshold = p__get_sbh_threshold();
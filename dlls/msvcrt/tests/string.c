@@ -2102,6 +2102,11 @@ static void test__strtod(void)
         { ".00", 3, 0 },
         { "-0.", 3, 0 },
         { "0e13", 4, 0 },
+        { "9007199254740993", 16, 9007199254740992.0 },
+        { "9007199254740995", 16, 9007199254740996.0 },
+        { "4503599627370497.5", 18, 4503599627370498.0 },
+        { "123456789012345678e9", 20, 123456789012345678e9 },
+        { "0.0000000000001", 15, 1e-13 },
     };
     const char overflow[] = "1d9999999999999999999";
 
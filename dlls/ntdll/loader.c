@@ -88,6 +88,7 @@ static const WCHAR system_dir[] = L"C:\\windows\\system32\\";
 static const WCHAR system_path[] = L"C:\\windows\\system32;C:\\windows\\system;C:\\windows";
 
 static BOOL is_prefix_bootstrap;  /* are we bootstrapping the prefix? */
+static BOOL prefetch_dlls;        /* start reading imported dlls before loading them */
 static BOOL imports_fixup_done = FALSE;  /* set once the imports have been fixed up, before attaching them */
 static BOOL process_detaching = FALSE;  /* set on process detach to avoid deadlocks with thread detach */
 static int free_lib_count;   /* recursion depth of LdrUnloadDll calls */
@@ -141,6 +142,17 @@ typedef struct _wine_modref
     BOOL                  system;
 } WINE_MODREF;
 
+/* result of the search for an imported dll, done ahead of loading it */
+struct prefetched_dll
+{
+    UNICODE_STRING            nt_name;
+    HANDLE                    mapping;
+    SECTION_IMAGE_INFORMATION image_info;
+    struct file_id            id;
+    BOOL                      redirected;
+    BOOL                      system;
+};
+
 static UINT tls_module_count = 32;     /* number of modules with TLS directory */
 static IMAGE_TLS_DIRECTORY *tls_dirs;  /* array of TLS directories */
 
@@ -190,6 +202,12 @@ static WINE_MODREF *last_failed_modref;
 static LDR_DDAG_NODE *node_ntdll, *node_kernel32;
 
 static NTSTATUS load_dll( const WCHAR *load_path, const WCHAR *libname, DWORD flags, WINE_MODREF** pwm, BOOL system );
+static NTSTATUS load_prefetched_dll( const WCHAR *load_path, const WCHAR *libname, DWORD flags, WINE_MODREF **pwm,
+                                     BOOL system, struct prefetched_dll *prefetched );
+static NTSTATUS search_dll( const WCHAR *load_path, const WCHAR *libname, UNICODE_STRING *nt_name,
+                            WINE_MODREF **pwm, HANDLE *mapping, SECTION_IMAGE_INFORMATION *image_info,
+                            struct file_id *id, BOOL *redirected, BOOL *system );
+static NTSTATUS find_apiset_dll( const WCHAR *name, WCHAR **fullname );
 static NTSTATUS process_attach( LDR_DDAG_NODE *node, LPVOID lpReserved );
 static FARPROC find_ordinal_export( HMODULE module, const IMAGE_EXPORT_DIRECTORY *exports,
                                     DWORD exp_size, DWORD ordinal, LPCWSTR load_path,
@@ -1132,13 +1150,129 @@ void * WINAPI RtlFindExportedRoutineByName( HMODULE module, const char *name )
 }
 
 
+/*************************************************************************
+ *		is_at_original_base
+ *
+ * Check whether a module has been loaded at the address it was linked for.
+ */
+static BOOL is_at_original_base( const WINE_MODREF *wm )
+{
+    return wm->ldr.OriginalBase && wm->ldr.OriginalBase == (ULONG_PTR)wm->ldr.DllBase;
+}
+
+
+/*************************************************************************
+ *		is_bound_forwarder_valid
+ *
+ * Check that a module referenced by a bound import forwarder is still the one it was bound to.
+ * The loader_section must be locked while calling this function.
+ */
+static BOOL is_bound_forwarder_valid( const char *name, DWORD timestamp )
+{
+    WCHAR buffer[256];
+    WINE_MODREF *wm;
+    DWORD len = strlen( name );
+
+    if (len >= ARRAY_SIZE(buffer)) return FALSE;
+    ascii_to_unicode( buffer, name, len + 1 );
+    if (!(wm = find_basename_module( buffer ))) return FALSE;
+    return wm->ldr.TimeDateStamp == timestamp && is_at_original_base( wm );
+}
+
+
+/*************************************************************************
+ *		is_bound_import_valid
+ *
+ * Check whether the addresses stored in the import address table by the binder
+ * are still correct, so that resolving the imports can be skipped entirely.
+ * For a new style binding, the bound import directory and the matching descriptor
+ * are returned on success, so that the caller can reference the forwarded modules.
+ * The loader_section must be locked while calling this function.
+ */
+static BOOL is_bound_import_valid( const WINE_MODREF *wm, const IMAGE_IMPORT_DESCRIPTOR *descr,
+                                   const WINE_MODREF *imp, const IMAGE_BOUND_IMPORT_DESCRIPTOR **dir_ret,
+                                   const IMAGE_BOUND_IMPORT_DESCRIPTOR **bound_ret )
+{
+    const IMAGE_BOUND_IMPORT_DESCRIPTOR *bound, *start;
+    const IMAGE_BOUND_FORWARDER_REF *fwd;
+    const char *name = get_rva( wm->ldr.DllBase, descr->Name );
+    const char *end;
+    DWORD i, size;
+
+    *dir_ret = *bound_ret = NULL;
+    if (!descr->TimeDateStamp) return FALSE;
+    if (TRACE_ON(relay) || TRACE_ON(snoop)) return FALSE;
+    if (!is_at_original_base( imp )) return FALSE;
+
+    /* old style binding, forwarders are not bound */
+    if (descr->TimeDateStamp != ~0u)
+        return descr->TimeDateStamp == imp->ldr.TimeDateStamp && descr->ForwarderChain == ~0u;
+
+    if (!(start = RtlImageDirectoryEntryToData( wm->ldr.DllBase, TRUE,
+                                                IMAGE_DIRECTORY_ENTRY_BOUND_IMPORT, &size )))
+        return FALSE;
+    end = (const char *)start + size;
+
+    bound = start;
+    while ((const char *)(bound + 1) <= end && bound->OffsetModuleName)
+    {
+        fwd = (const IMAGE_BOUND_FORWARDER_REF *)(bound + 1);
+        if ((const char *)(fwd + bound->NumberOfModuleForwarderRefs) > end) return FALSE;
+
+        if (!_stricmp( (const char *)start + bound->OffsetModuleName, name ))
+        {
+            if (bound->TimeDateStamp != imp->ldr.TimeDateStamp) return FALSE;
+            for (i = 0; i < bound->NumberOfModuleForwarderRefs; i++)
+                if (!is_bound_forwarder_valid( (const char *)start + fwd[i].OffsetModuleName,
+                                               fwd[i].TimeDateStamp ))
+                    return FALSE;
+            *dir_ret = start;
+            *bound_ret = bound;
+            return TRUE;
+        }
+        bound = (const IMAGE_BOUND_IMPORT_DESCRIPTOR *)(fwd + bound->NumberOfModuleForwarderRefs);
+    }
+    return FALSE;
+}
+
+
+/*************************************************************************
+ *		reference_bound_forwarders
+ *
+ * Take a reference on the modules used by the forwarders of a bound import, the
+ * same way find_forwarded_export does when the imports are resolved.
+ * The loader_section must be locked while calling this function.
+ */
+static void reference_bound_forwarders( WINE_MODREF *wm, const IMAGE_BOUND_IMPORT_DESCRIPTOR *dir,
+                                        const IMAGE_BOUND_IMPORT_DESCRIPTOR *bound )
+{
+    const IMAGE_BOUND_FORWARDER_REF *fwd = (const IMAGE_BOUND_FORWARDER_REF *)(bound + 1);
+    const char *name;
+    WCHAR buffer[256];
+    WINE_MODREF *fwd_wm;
+    DWORD i;
+
+    for (i = 0; i < bound->NumberOfModuleForwarderRefs; i++)
+    {
+        name = (const char *)dir + fwd[i].OffsetModuleName;
+        ascii_to_unicode( buffer, name, strlen( name ) + 1 );
+        if (!(fwd_wm = find_basename_module( buffer ))) continue;
+        if (fwd_wm->ldr.DdagNode == node_ntdll || fwd_wm->ldr.DdagNode == node_kernel32) continue;
+        TRACE_(imports)( "bound forwarder %s used by %s\n", debugstr_a(name), debugstr_w(wm->ldr.BaseDllName.Buffer) );
+        if (fwd_wm->ldr.LoadCount != -1) fwd_wm->ldr.LoadCount++;
+        add_module_dependency( wm->ldr.DdagNode, fwd_wm->ldr.DdagNode );
+    }
+}
+
+
 /*************************************************************************
  *		import_dll
  *
  * Import the dll specified by the given import descriptor.
  * The loader_section must be locked while calling this function.
  */
-static BOOL import_dll( WINE_MODREF *wm, const IMAGE_IMPORT_DESCRIPTOR *descr, LPCWSTR load_path, WINE_MODREF **pwm )
+static BOOL import_dll( WINE_MODREF *wm, const IMAGE_IMPORT_DESCRIPTOR *descr, LPCWSTR load_path,
+                        struct prefetched_dll *prefetched, WINE_MODREF **pwm )
 {
     HMODULE module = wm->ldr.DllBase;
     BOOL system = wm->system || (wm->ldr.Flags & LDR_WINE_INTERNAL);
@@ -1146,6 +1280,7 @@ static BOOL import_dll( WINE_MODREF *wm, const IMAGE_IMPORT_DESCRIPTOR *descr, L
     WINE_MODREF *wmImp;
     HMODULE imp_mod;
     const IMAGE_EXPORT_DIRECTORY *exports;
+    const IMAGE_BOUND_IMPORT_DESCRIPTOR *bound_dir, *bound;
     DWORD exp_size;
     const IMAGE_THUNK_DATA *import_list;
     IMAGE_THUNK_DATA *thunk_list;
@@ -1170,7 +1305,7 @@ static BOOL import_dll( WINE_MODREF *wm, const IMAGE_IMPORT_DESCRIPTOR *descr, L
     }
 
     status = build_import_name( wm, buffer, name, len );
-    if (!status) status = load_dll( load_path, buffer, 0, &wmImp, system );
+    if (!status) status = load_prefetched_dll( load_path, buffer, 0, &wmImp, system, prefetched );
 
     if (status)
     {
@@ -1183,6 +1318,14 @@ static BOOL import_dll( WINE_MODREF *wm, const IMAGE_IMPORT_DESCRIPTOR *descr, L
         return FALSE;
     }
 
+    if (is_bound_import_valid( wm, descr, wmImp, &bound_dir, &bound ))
+    {
+        TRACE_(imports)( "using bound imports for %s from %s\n", name, debugstr_w(wm->ldr.BaseDllName.Buffer) );
+        if (bound) reference_bound_forwarders( wm, bound_dir, bound );
+        *pwm = wmImp;
+        return TRUE;
+    }
+
     /* unprotect the import address table since it can be located in
      * readonly section */
     while (import_list[protect_size].u1.Ordinal) protect_size++;
@@ -1472,6 +1615,66 @@ static NTSTATUS fixup_imports_ilonly( WINE_MODREF *wm, LPCWSTR load_path, void *
 }
 
 
+/****************************************************************
+ *       free_prefetched_dll
+ */
+static void free_prefetched_dll( struct prefetched_dll *prefetched )
+{
+    if (prefetched->mapping) NtClose( prefetched->mapping );
+    RtlFreeUnicodeString( &prefetched->nt_name );
+    memset( prefetched, 0, sizeof(*prefetched) );
+}
+
+
+/****************************************************************
+ *       prefetch_imports
+ *
+ * Search for the dlls imported by a module that are not loaded yet, and start reading
+ * the files that will be mapped for them, so that the disk reads overlap instead of
+ * happening one dll at a time. The search results are kept in the prefetched array,
+ * and used by import_dll() in place of a second search; the dlls are still loaded
+ * in import order.
+ */
+static void prefetch_imports( WINE_MODREF *wm, const IMAGE_IMPORT_DESCRIPTOR *imports, int nb_imports,
+                              LPCWSTR load_path, struct prefetched_dll *prefetched )
+{
+    struct prefetch_dll_params params;
+    const IMAGE_THUNK_DATA *import_list;
+    WINE_MODREF *imp;
+    WCHAR buffer[256];
+    const char *name;
+    BOOL system;
+    int i;
+
+    for (i = 0; i < nb_imports; i++)
+    {
+        if (imports[i].OriginalFirstThunk) import_list = get_rva( wm->ldr.DllBase, imports[i].OriginalFirstThunk );
+        else import_list = get_rva( wm->ldr.DllBase, imports[i].FirstThunk );
+        if (!import_list->u1.Ordinal) continue;
+
+        name = get_rva( wm->ldr.DllBase, imports[i].Name );
+        if (build_import_name( wm, buffer, name, strlen(name) )) continue;
+        if (find_basename_module( buffer )) continue;
+
+        imp = NULL;
+        system = wm->system || (wm->ldr.Flags & LDR_WINE_INTERNAL);
+        if (search_dll( load_path, buffer, &prefetched[i].nt_name, &imp, &prefetched[i].mapping,
+                        &prefetched[i].image_info, &prefetched[i].id, &prefetched[i].redirected, &system ) ||
+            imp || !prefetched[i].mapping)
+        {
+            free_prefetched_dll( &prefetched[i] );
+            continue;
+        }
+        prefetched[i].system = system;
+
+        TRACE( "prefetching %s\n", debugstr_us(&prefetched[i].nt_name) );
+        params.nt_name = prefetched[i].nt_name.Buffer;
+        params.machine = prefetched[i].image_info.Machine;
+        WINE_UNIX_CALL( unix_prefetch_dll, &params );
+    }
+}
+
+
 /****************************************************************
  *       fixup_imports
  *
@@ -1481,6 +1684,7 @@ static NTSTATUS fixup_imports_ilonly( WINE_MODREF *wm, LPCWSTR load_path, void *
 static NTSTATUS fixup_imports( WINE_MODREF *wm, LPCWSTR load_path )
 {
     const IMAGE_IMPORT_DESCRIPTOR *imports;
+    struct prefetched_dll *prefetched = NULL;
     SINGLE_LIST_ENTRY *dep_after;
     WINE_MODREF *imp;
     int i, nb_imports;
@@ -1505,6 +1709,10 @@ static NTSTATUS fixup_imports( WINE_MODREF *wm, LPCWSTR load_path )
     if (!create_module_activation_context( &wm->ldr ))
         RtlActivateActivationContext( 0, wm->ldr.ActivationContext, &cookie );
 
+    if (prefetch_dlls && (prefetched = RtlAllocateHeap( GetProcessHeap(), HEAP_ZERO_MEMORY,
+                                                        nb_imports * sizeof(*prefetched) )))
+        prefetch_imports( wm, imports, nb_imports, load_path, prefetched );
+
     /* load the imported modules. They are automatically
      * added to the modref list of the process.
      */
@@ -1512,11 +1720,13 @@ static NTSTATUS fixup_imports( WINE_MODREF *wm, LPCWSTR load_path )
     for (i = 0; i < nb_imports; i++)
     {
         dep_after = wm->ldr.DdagNode->Dependencies.Tail;
-        if (!import_dll( wm, &imports[i], load_path, &imp ))
+        if (!import_dll( wm, &imports[i], load_path, prefetched ? &prefetched[i] : NULL, &imp ))
             status = STATUS_DLL_NOT_FOUND;
         else if (imp && imp->ldr.DdagNode != node_ntdll && imp->ldr.DdagNode != node_kernel32)
             add_module_dependency_after( wm->ldr.DdagNode, imp->ldr.DdagNode, dep_after );
+        if (prefetched) free_prefetched_dll( &prefetched[i] );
     }
+    RtlFreeHeap( GetProcessHeap(), 0, prefetched );
     if (wm->ldr.ActivationContext) RtlDeactivateActivationContext( 0, cookie );
     return status;
 }
@@ -2825,6 +3035,14 @@ static NTSTATUS load_native_dll( LPCWSTR load_path, const UNICODE_STRING *nt_nam
     if (NT_SUCCESS(status)) status = build_module( load_path, nt_name, &module, image_info, id,
                                                    flags, system, redirected, pwm );
     if (status && module) NtUnmapViewOfSection( NtCurrentProcess(), module );
+    else if (!status)
+    {
+        void *base;
+
+        /* needed to validate the bound imports of the modules importing this one */
+        if (!NtQuerySection( mapping, SectionOriginalBaseInformation, &base, sizeof(base), NULL ))
+            (*pwm)->ldr.OriginalBase = (ULONG_PTR)base;
+    }
     return status;
 }
 
@@ -3196,6 +3414,106 @@ done:
 }
 
 
+/* cached result of a dll search */
+struct search_cache_entry
+{
+    struct list  entry;
+    WCHAR       *paths;   /* search path */
+    WCHAR       *name;    /* dll name */
+    int          index;   /* index of the directory containing the dll in the path, -1 if not found */
+};
+
+#define MAX_SEARCH_CACHE 256
+
+static struct list search_cache = LIST_INIT( search_cache );
+static unsigned int search_cache_size, search_cache_hits, search_cache_misses;
+static unsigned int search_cache_depth;  /* nesting level of loads sharing the search cache */
+
+
+/***********************************************************************
+ *	remove_search_cache
+ */
+static void remove_search_cache( struct search_cache_entry *entry )
+{
+    list_remove( &entry->entry );
+    RtlFreeHeap( GetProcessHeap(), 0, entry );
+    search_cache_size--;
+}
+
+
+/***********************************************************************
+ *	find_search_cache
+ */
+static struct search_cache_entry *find_search_cache( const WCHAR *paths, const WCHAR *name )
+{
+    struct search_cache_entry *entry;
+
+    LIST_FOR_EACH_ENTRY( entry, &search_cache, struct search_cache_entry, entry )
+    {
+        if (wcsicmp( entry->name, name ) || wcscmp( entry->paths, paths )) continue;
+        list_remove( &entry->entry );
+        list_add_head( &search_cache, &entry->entry );
+        return entry;
+    }
+    return NULL;
+}
+
+
+/***********************************************************************
+ *	add_search_cache
+ */
+static void add_search_cache( const WCHAR *paths, const WCHAR *name, int index )
+{
+    struct search_cache_entry *entry;
+    SIZE_T paths_len = wcslen( paths ) + 1, name_len = wcslen( name ) + 1;
+
+    if (search_cache_size == MAX_SEARCH_CACHE)
+        remove_search_cache( LIST_ENTRY( list_tail( &search_cache ), struct search_cache_entry, entry ));
+
+    if (!(entry = RtlAllocateHeap( GetProcessHeap(), 0,
+                                   sizeof(*entry) + (paths_len + name_len) * sizeof(WCHAR) ))) return;
+    entry->paths = (WCHAR *)(entry + 1);
+    entry->name  = entry->paths + paths_len;
+    entry->index = index;
+    memcpy( entry->paths, paths, paths_len * sizeof(WCHAR) );
+    memcpy( entry->name, name, name_len * sizeof(WCHAR) );
+    list_add_head( &search_cache, &entry->entry );
+    search_cache_size++;
+}
+
+
+/***********************************************************************
+ *	begin_search_cache
+ *
+ * Start a load operation during which dll search results are cached. The cache
+ * only lives until the outermost operation ends, so that files and directories
+ * created or removed in between are always seen by the next load.
+ * The loader_section must be locked while calling this function.
+ */
+static void begin_search_cache(void)
+{
+    search_cache_depth++;
+}
+
+
+/***********************************************************************
+ *	end_search_cache
+ *
+ * The loader_section must be locked while calling this function.
+ */
+static void end_search_cache(void)
+{
+    struct list *ptr;
+
+    if (--search_cache_depth) return;
+    if (search_cache_hits || search_cache_misses)
+        TRACE( "%u hits, %u misses\n", search_cache_hits, search_cache_misses );
+    while ((ptr = list_head( &search_cache )))
+        remove_search_cache( LIST_ENTRY( ptr, struct search_cache_entry, entry ));
+    search_cache_hits = search_cache_misses = 0;
+}
+
+
 /***********************************************************************
  *	search_dll_file
  *
@@ -3205,12 +3523,41 @@ static NTSTATUS search_dll_file( LPCWSTR paths, LPCWSTR search, UNICODE_STRING *
                                  WINE_MODREF **pwm, HANDLE *mapping, SECTION_IMAGE_INFORMATION *image_info,
                                  struct file_id *id )
 {
+    struct search_cache_entry *cached;
+    const WCHAR *dirs;
     WCHAR *name;
-    BOOL found_image = FALSE;
+    BOOL found_image = FALSE, cacheable = TRUE;
     NTSTATUS status = STATUS_DLL_NOT_FOUND;
+    int index, only = -1;
     ULONG len;
 
     if (!paths) paths = default_load_path;
+
+    /* the results depend on the file system redirection state in wow64 */
+    if (!search_cache_depth || (NtCurrentTeb64() && !NtCurrentTeb64()->TlsSlots[WOW64_TLS_FILESYSREDIR]))
+    {
+        cached = NULL;
+        cacheable = FALSE;
+    }
+    else cached = find_search_cache( paths, search );
+
+    if (cached)
+    {
+        search_cache_hits++;
+        TRACE( "cache hit for %s (%u hits, %u misses)\n", debugstr_w(search), search_cache_hits, search_cache_misses );
+        if (cached->index == -1)
+        {
+            nt_name->Buffer = NULL;
+            return STATUS_DLL_NOT_FOUND;
+        }
+        only = cached->index;
+    }
+    else if (cacheable)
+    {
+        search_cache_misses++;
+        TRACE( "cache miss for %s (%u hits, %u misses)\n", debugstr_w(search), search_cache_hits, search_cache_misses );
+    }
+
     len = wcslen( paths );
 
     if (len < wcslen( system_dir )) len = wcslen( system_dir );
@@ -3219,14 +3566,23 @@ static NTSTATUS search_dll_file( LPCWSTR paths, LPCWSTR search, UNICODE_STRING *
     if (!(name = RtlAllocateHeap( GetProcessHeap(), 0, len * sizeof(WCHAR) )))
         return STATUS_NO_MEMORY;
 
-    while (*paths)
+retry:
+    dirs = paths;
+    index = 0;
+    while (*dirs)
     {
-        LPCWSTR ptr = paths;
+        LPCWSTR ptr = dirs;
 
         while (*ptr && *ptr != ';') ptr++;
-        len = ptr - paths;
+        len = ptr - dirs;
         if (*ptr == ';') ptr++;
-        memcpy( name, paths, len * sizeof(WCHAR) );
+        if (only != -1 && index != only)
+        {
+            dirs = ptr;
+            index++;
+            continue;
+        }
+        memcpy( name, dirs, len * sizeof(WCHAR) );
         if (len && name[len - 1] != '\\') name[len++] = '\\';
         wcscpy( name + len, search );
 
@@ -3237,12 +3593,23 @@ static NTSTATUS search_dll_file( LPCWSTR paths, LPCWSTR search, UNICODE_STRING *
         if (status == STATUS_NOT_SUPPORTED) found_image = TRUE;
         else if (status != STATUS_DLL_NOT_FOUND) goto done;
         RtlFreeUnicodeString( nt_name );
-        paths = ptr;
+        dirs = ptr;
+        index++;
+    }
+
+    if (only != -1)
+    {
+        /* the dll is no longer in the cached directory */
+        remove_search_cache( cached );
+        only = -1;
+        goto retry;
     }
 
     if (found_image) status = STATUS_NOT_SUPPORTED;
+    else if (cacheable) add_search_cache( paths, search, -1 );
 
 done:
+    if (!status && only == -1 && cacheable) add_search_cache( paths, search, index );
     RtlFreeHeap( GetProcessHeap(), 0, name );
     return status;
 }
@@ -3314,32 +3681,65 @@ static NTSTATUS find_dll_file( const WCHAR *load_path, const WCHAR *libname, UNI
 
 
 /***********************************************************************
- *	load_dll  (internal)
+ *	search_dll  (internal)
  *
- * Load a PE style module according to the load order.
+ * Search for a dll the way load_dll() does, first along the system path for system modules.
+ * On return, system is set if the dll was found along the system path.
+ */
+static NTSTATUS search_dll( const WCHAR *load_path, const WCHAR *libname, UNICODE_STRING *nt_name,
+                            WINE_MODREF **pwm, HANDLE *mapping, SECTION_IMAGE_INFORMATION *image_info,
+                            struct file_id *id, BOOL *redirected, BOOL *system )
+{
+    NTSTATUS nts = STATUS_DLL_NOT_FOUND;
+
+    *redirected = FALSE;
+    if (*system && system_dll_path.Buffer)
+        nts = search_dll_file( system_dll_path.Buffer, libname, nt_name, pwm, mapping, image_info, id );
+
+    if (nts)
+    {
+        nts = find_dll_file( load_path, libname, nt_name, pwm, mapping, image_info, id, redirected, FALSE );
+        *system = FALSE;
+    }
+    return nts;
+}
+
+
+/***********************************************************************
+ *	load_prefetched_dll  (internal)
+ *
+ * Load a PE style module according to the load order, using the search
+ * results from prefetch_imports() if there are any.
  * The loader_section must be locked while calling this function.
  */
-static NTSTATUS load_dll( const WCHAR *load_path, const WCHAR *libname, DWORD flags, WINE_MODREF** pwm, BOOL system )
+static NTSTATUS load_prefetched_dll( const WCHAR *load_path, const WCHAR *libname, DWORD flags, WINE_MODREF **pwm,
+                                     BOOL system, struct prefetched_dll *prefetched )
 {
     UNICODE_STRING nt_name;
     struct file_id id;
     HANDLE mapping = 0;
     SECTION_IMAGE_INFORMATION image_info;
-    NTSTATUS nts = STATUS_DLL_NOT_FOUND;
+    NTSTATUS nts;
     BOOL redirected;
     void *prev;
 
     TRACE( "looking for %s in %s\n", debugstr_w(libname), debugstr_w(load_path) );
 
-    if (system && system_dll_path.Buffer)
-        nts = search_dll_file( system_dll_path.Buffer, libname, &nt_name, pwm, &mapping, &image_info, &id );
-
-    if (nts)
-    {
-        nts = find_dll_file( load_path, libname, &nt_name, pwm, &mapping, &image_info, &id,
-                             &redirected, FALSE );
-        system = FALSE;
+    /* a previous import may have loaded it in the meantime */
+    if (prefetched && prefetched->mapping && !find_basename_module( libname ))
+    {
+        TRACE( "using prefetched %s\n", debugstr_us(&prefetched->nt_name) );
+        nt_name = prefetched->nt_name;
+        mapping = prefetched->mapping;
+        image_info = prefetched->image_info;
+        id = prefetched->id;
+        redirected = prefetched->redirected;
+        system = prefetched->system;
+        memset( prefetched, 0, sizeof(*prefetched) );
+        *pwm = NULL;
+        nts = STATUS_SUCCESS;
     }
+    else nts = search_dll( load_path, libname, &nt_name, pwm, &mapping, &image_info, &id, &redirected, &system );
 
     if (*pwm)  /* found already loaded module */
     {
@@ -3383,6 +3783,18 @@ done:
 }
 
 
+/***********************************************************************
+ *	load_dll  (internal)
+ *
+ * Load a PE style module according to the load order.
+ * The loader_section must be locked while calling this function.
+ */
+static NTSTATUS load_dll( const WCHAR *load_path, const WCHAR *libname, DWORD flags, WINE_MODREF** pwm, BOOL system )
+{
+    return load_prefetched_dll( load_path, libname, flags, pwm, system, NULL );
+}
+
+
 /***********************************************************************
  *              __wine_ctrl_routine
  */
@@ -3461,7 +3873,9 @@ NTSTATUS WINAPI DECLSPEC_HOTPATCH LdrLoadDll(LPCWSTR search_path, DWORD *load_fl
 
     RtlEnterCriticalSection( &loader_section );
 
+    begin_search_cache();
     nts = load_dll( path_name, dllname ? dllname : libname->Buffer, flags, &wm, FALSE );
+    end_search_cache();
 
     if (nts == STATUS_SUCCESS)
     {
@@ -4179,6 +4593,7 @@ static void load_global_options(void)
 {
     OBJECT_ATTRIBUTES attr;
     UNICODE_STRING bootstrap_mode_str = RTL_CONSTANT_STRING( L"WINEBOOTSTRAPMODE" );
+    UNICODE_STRING prefetch_str = RTL_CONSTANT_STRING( L"WINEPREFETCHDLLS" );
     UNICODE_STRING session_manager_str =
         RTL_CONSTANT_STRING( L"\\Registry\\Machine\\System\\CurrentControlSet\\Control\\Session Manager" );
     UNICODE_STRING val_str;
@@ -4187,6 +4602,8 @@ static void load_global_options(void)
     val_str.MaximumLength = 0;
     is_prefix_bootstrap =
         RtlQueryEnvironmentVariable_U( NULL, &bootstrap_mode_str, &val_str ) != STATUS_VARIABLE_NOT_FOUND;
+    prefetch_dlls =
+        RtlQueryEnvironmentVariable_U( NULL, &prefetch_str, &val_str ) != STATUS_VARIABLE_NOT_FOUND;
 
     InitializeObjectAttributes( &attr, &session_manager_str, OBJ_CASE_INSENSITIVE, 0, NULL );
     if (!NtOpenKey( &hkey, KEY_QUERY_VALUE, &attr ))
@@ -4492,10 +4909,12 @@ void loader_init( CONTEXT *context, void **entry )
         if (needs_elevation())
             elevate_token();
         get_env_var( L"WINESYSTEMDLLPATH", 0, &system_dll_path );
+        begin_search_cache();
         if (wm->ldr.Flags & LDR_COR_ILONLY)
             status = fixup_imports_ilonly( wm, NULL, entry );
         else
             status = fixup_imports( wm, NULL );
+        end_search_cache();
 
         if (status)
         {
@@ -1896,6 +1896,65 @@ static void test_blocking(ULONG options)
     CloseHandle(thread);
 }
 
+static void test_large_buffer_read(ULONG pipe_type)
+{
+    static const DWORD sizes[] = {1, 100, 4000};
+    char *in_buffer, *out_buffer;
+    HANDLE read, write;
+    DWORD size, i, j;
+    BOOL ret;
+
+    if (!create_pipe_pair( &read, &write, PIPE_ACCESS_INBOUND, pipe_type, 8192 )) return;
+
+    in_buffer = malloc( 8192 );
+    out_buffer = malloc( 8192 );
+    for (i = 0; i < 8192; i++) in_buffer[i] = i * 7;
+
+    /* the read buffer is larger than what was written */
+    for (i = 0; i < ARRAY_SIZE(sizes); i++)
+    {
+        ret = WriteFile( write, in_buffer + i, sizes[i], &size, NULL );
+        ok( ret && size == sizes[i], "WriteFile returned %d, size %lu, error %lu\n", ret, size, GetLastError() );
+
+        memset( out_buffer, 0xcc, 8192 );
+        ret = ReadFile( read, out_buffer, 8192, &size, NULL );
+        ok( ret, "ReadFile failed, error %lu\n", GetLastError() );
+        ok( size == sizes[i], "got size %lu, expected %lu\n", size, sizes[i] );
+        ok( !memcmp( out_buffer, in_buffer + i, sizes[i] ), "data didn't match\n" );
+        ok( (BYTE)out_buffer[sizes[i]] == 0xcc, "buffer overrun\n" );
+    }
+
+    /* several queued writes are returned by one read in byte mode only */
+    for (i = 0; i < ARRAY_SIZE(sizes); i++)
+    {
+        ret = WriteFile( write, in_buffer, sizes[i], &size, NULL );
+        ok( ret && size == sizes[i], "WriteFile returned %d, size %lu, error %lu\n", ret, size, GetLastError() );
+    }
+    for (i = 0; i < ARRAY_SIZE(sizes); i++)
+    {
+        memset( out_buffer, 0xcc, 8192 );
+        ret = ReadFile( read, out_buffer, 8192, &size, NULL );
+        ok( ret, "ReadFile failed, error %lu\n", GetLastError() );
+        if (pipe_type & PIPE_READMODE_MESSAGE)
+        {
+            ok( size == sizes[i], "got size %lu, expected %lu\n", size, sizes[i] );
+            ok( !memcmp( out_buffer, in_buffer, sizes[i] ), "data didn't match\n" );
+        }
+        else
+        {
+            ok( size == sizes[0] + sizes[1] + sizes[2], "got size %lu\n", size );
+            for (j = 0, size = 0; j < ARRAY_SIZE(sizes); size += sizes[j++])
+                ok( !memcmp( out_buffer + size, in_buffer, sizes[j] ), "data %lu didn't match\n", j );
+            break;
+        }
+    }
+
+    free( in_buffer );
+    free( out_buffer );
+    CloseHandle( read );
+    CloseHandle( write );
+}
+
 static void test_volume_info(void)
 {
     FILE_FS_DEVICE_INFORMATION *device_info;
@@ -3210,6 +3269,8 @@ START_TEST(pipe)
     read_pipe_test(PIPE_ACCESS_OUTBOUND, PIPE_TYPE_MESSAGE | PIPE_READMODE_MESSAGE);
 
     test_transceive();
+    test_large_buffer_read(PIPE_TYPE_BYTE);
+    test_large_buffer_read(PIPE_TYPE_MESSAGE | PIPE_READMODE_MESSAGE);
     test_volume_info();
     test_file_info();
     test_security_info();
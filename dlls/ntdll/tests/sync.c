@@ -1427,6 +1427,92 @@ static void test_barrier(void)
     }
 }
 
+struct slist_test_item
+{
+    SLIST_ENTRY entry;
+    LONG owners;
+    LONG pops;
+};
+
+struct slist_test_params
+{
+    SLIST_HEADER *list;
+    HANDLE start;
+    unsigned int iterations;
+    LONG failures;
+};
+
+static DWORD WINAPI slist_test_thread( void *arg )
+{
+    struct slist_test_params *params = arg;
+    struct slist_test_item *item;
+    unsigned int i;
+
+    WaitForSingleObject( params->start, INFINITE );
+
+    for (i = 0; i < params->iterations; i++)
+    {
+        if (!(item = (struct slist_test_item *)RtlInterlockedPopEntrySList( params->list )))
+        {
+            InterlockedIncrement( &params->failures );
+            continue;
+        }
+        if (InterlockedIncrement( &item->owners ) != 1) InterlockedIncrement( &params->failures );
+        item->pops++;
+        InterlockedDecrement( &item->owners );
+        RtlInterlockedPushEntrySList( params->list, &item->entry );
+    }
+    return 0;
+}
+
+static void test_slist_contention(void)
+{
+    static const unsigned int thread_counts[] = {1, 2, 4, 8, 16};
+    static const unsigned int item_count = 64, iterations = 20000;
+    struct slist_test_params params;
+    struct slist_test_item *items;
+    HANDLE threads[16];
+    SLIST_HEADER list;
+    unsigned int i, j, total;
+
+    items = VirtualAlloc( NULL, item_count * sizeof(*items), MEM_COMMIT, PAGE_READWRITE );
+    ok( items != NULL, "VirtualAlloc failed, error %lu\n", GetLastError() );
+    if (!items) return;
+    params.start = CreateEventW( NULL, TRUE, FALSE, NULL );
+    params.list = &list;
+    params.iterations = iterations;
+
+    for (i = 0; i < ARRAY_SIZE(thread_counts); i++)
+    {
+        winetest_push_context( "%u threads", thread_counts[i] );
+
+        RtlInitializeSListHead( &list );
+        for (j = 0; j < item_count; j++)
+        {
+            items[j].pops = 0;
+            RtlInterlockedPushEntrySList( &list, &items[j].entry );
+        }
+        ResetEvent( params.start );
+        params.failures = 0;
+
+        for (j = 0; j < thread_counts[i]; j++)
+            threads[j] = CreateThread( NULL, 0, slist_test_thread, &params, 0, NULL );
+        SetEvent( params.start );
+        WaitForMultipleObjects( thread_counts[i], threads, TRUE, INFINITE );
+        for (j = 0; j < thread_counts[i]; j++) CloseHandle( threads[j] );
+
+        ok( !params.failures, "got %ld failures\n", params.failures );
+        ok( RtlQueryDepthSList( &list ) == item_count, "got depth %u\n", RtlQueryDepthSList( &list ) );
+        for (j = 0, total = 0; j < item_count; j++) total += items[j].pops;
+        ok( total == thread_counts[i] * iterations, "got %u pops\n", total );
+
+        winetest_pop_context();
+    }
+
+    CloseHandle( params.start );
+    VirtualFree( items, 0, MEM_RELEASE );
+}
+
 START_TEST(sync)
 {
     HMODULE module = GetModuleHandleA("ntdll.dll");
@@ -1483,4 +1569,5 @@ START_TEST(sync)
     test_completion_port_scheduling();
     test_delayexecution();
     test_barrier();
+    test_slist_contention();
 }
@@ -32,6 +32,7 @@
 #include <string.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 #include <unistd.h>
 
 #include "ntstatus.h"
@@ -64,6 +65,61 @@ static struct __wine_debug_channel *debug_options;
 
 static const char * const debug_classes[] = { "fixme", "err", "warn", "trace" };
 
+/*
+ * Binary trace rings, enabled by setting WINEDEBUGRING to a file name prefix.
+ *
+ * Each process maps a file named "<prefix>.<unix pid>", made of a header
+ * followed by an array of rings. A thread claims a free ring the first time
+ * it outputs a message and gives it back when it exits, so that each ring
+ * only ever has a single writer and doesn't need any locking. Every complete
+ * line of output is stored as a record instead of being written to stderr.
+ *
+ * Records are 16-byte aligned and never wrap around the end of the ring; a
+ * record with a zero tid means that the reader should continue at the start.
+ * The head is the total number of bytes written modulo 2^32, and it is only
+ * updated once a record is complete. Records between head - size and
+ * head - size + DEBUG_RING_MAX_RECORD may be in the process of being
+ * overwritten, so a live reader has to check the head again after copying.
+ */
+#define DEBUG_RING_MAGIC       0x676e6972  /* "ring" */
+#define DEBUG_RING_VERSION     1
+#define DEBUG_RING_COUNT       64
+#define DEBUG_RING_SIZE        0x40000
+#define DEBUG_RING_MAX_RECORD  0x1000
+
+struct debug_ring_header
+{
+    UINT      magic;      /* DEBUG_RING_MAGIC */
+    UINT      version;    /* DEBUG_RING_VERSION */
+    UINT      pid;        /* unix process id */
+    UINT      count;      /* number of rings following the header */
+    UINT      size;       /* size of the data area of each ring */
+    UINT      reserved;
+    ULONGLONG frequency;  /* timestamp counter frequency */
+};
+
+struct debug_ring
+{
+    LONG      owner;      /* thread id of the owning thread, 0 if free */
+    LONG      head;       /* number of bytes written, modulo 2^32 */
+    ULONGLONG reserved;
+    char      data[DEBUG_RING_SIZE];
+};
+
+struct debug_ring_record
+{
+    UINT      tid;        /* thread id, 0 if the reader should wrap around */
+    UINT      len;        /* length of the text, the record is padded to 16 bytes */
+    ULONGLONG time;       /* performance counter value */
+    char      text[];     /* message text, not null-terminated */
+};
+
+C_ASSERT( sizeof(struct debug_ring_header) % 16 == 0 );
+C_ASSERT( sizeof(struct debug_ring) % 16 == 0 );
+C_ASSERT( sizeof(struct debug_ring_record) == 16 );
+
+static struct debug_ring *debug_rings;
+
 /* get the debug info pointer for the current thread */
 static inline struct debug_info *get_info(void)
 {
@@ -75,6 +131,63 @@ static inline struct debug_info *get_info(void)
 #endif
 }
 
+/* get the trace ring of the current thread, claiming a free one if needed */
+static struct debug_ring *get_ring(void)
+{
+    struct ntdll_thread_data *thread_data = ntdll_get_thread_data();
+    LONG tid = GetCurrentThreadId();
+    unsigned int i;
+
+    if (thread_data->debug_ring) return &debug_rings[thread_data->debug_ring - 1];
+
+    for (i = 0; i < DEBUG_RING_COUNT; i++)
+    {
+        if (InterlockedCompareExchange( &debug_rings[i].owner, tid, 0 )) continue;
+        thread_data->debug_ring = i + 1;
+        return &debug_rings[i];
+    }
+    return NULL;
+}
+
+/* store a line of output into the trace ring of the current thread */
+static BOOL write_ring( const char *str, unsigned int len )
+{
+    struct debug_ring *ring;
+    struct debug_ring_record *record;
+    LARGE_INTEGER counter;
+    unsigned int head, pos, size;
+
+    if (!debug_rings || !init_done || !(ring = get_ring())) return FALSE;
+
+    len = min( len, DEBUG_RING_MAX_RECORD - sizeof(*record) );
+    size = (sizeof(*record) + len + 15) & ~15;
+    head = ring->head;
+    pos = head % DEBUG_RING_SIZE;
+    if (pos + size > DEBUG_RING_SIZE)
+    {
+        record = (struct debug_ring_record *)(ring->data + pos);
+        record->tid = 0;
+        record->len = 0;
+        head += DEBUG_RING_SIZE - pos;
+        pos = 0;
+    }
+    NtQueryPerformanceCounter( &counter, NULL );
+    record = (struct debug_ring_record *)(ring->data + pos);
+    record->tid = GetCurrentThreadId();
+    record->len = len;
+    record->time = counter.QuadPart;
+    memcpy( record->text, str, len );
+    WriteRelease( &ring->head, head + size );
+    return TRUE;
+}
+
+/* write a line of output to the trace ring or to stderr */
+static int write_output( const char *str, unsigned int len )
+{
+    if (write_ring( str, len )) return len;
+    return write( 2, str, len );
+}
+
 /* add a string to the output buffer */
 static int append_output( struct debug_info *info, const char *str, size_t len )
 {
@@ -205,8 +318,8 @@ static void init_options(void)
 
     nb_debug_options = 0;
 
-    /* check for stderr pointing to /dev/null */
-    if (!fstat( 2, &st1 ) && S_ISCHR(st1.st_mode) &&
+    /* check for stderr pointing to /dev/null, unless traces go to a ring */
+    if (!getenv( "WINEDEBUGRING" ) && !fstat( 2, &st1 ) && S_ISCHR(st1.st_mode) &&
         !stat( "/dev/null", &st2 ) && S_ISCHR(st2.st_mode) &&
         st1.st_rdev == st2.st_rdev)
     {
@@ -278,7 +391,7 @@ NTSTATUS unixcall_wine_dbg_write( void *args )
 {
     struct wine_dbg_write_params *params = args;
 
-    return write( 2, params->str, params->len );
+    return write_output( params->str, params->len );
 }
 
 #ifdef _WIN64
@@ -293,7 +406,7 @@ NTSTATUS wow64_wine_dbg_write( void *args )
         unsigned int len;
     } const *params32 = args;
 
-    return write( 2, ULongToPtr(params32->str), params32->len );
+    return write_output( ULongToPtr(params32->str), params32->len );
 }
 #endif
 
@@ -309,7 +422,7 @@ int __cdecl __wine_dbg_output( const char *str )
     if (end)
     {
         ret += append_output( info, str, end + 1 - str );
-        write( 2, info->output, info->out_pos );
+        write_output( info->output, info->out_pos );
         info->out_pos = 0;
         str = end + 1;
     }
@@ -332,7 +445,8 @@ int __cdecl __wine_dbg_header( enum __wine_debug_class cls, struct __wine_debug_
     /* only print header if we are at the beginning of the line */
     if (info->out_pos) return 0;
 
-    if (init_done)
+    /* ring records already contain that information */
+    if (init_done && (!debug_rings || !get_ring()))
     {
         if (TRACE_ON(timestamp))
         {
@@ -349,6 +463,63 @@ int __cdecl __wine_dbg_header( enum __wine_debug_class cls, struct __wine_debug_
     return info->out_pos;
 }
 
+/***********************************************************************
+ *		init_debug_rings
+ */
+static void init_debug_rings(void)
+{
+    const char *prefix = getenv( "WINEDEBUGRING" );
+    struct debug_ring_header *header;
+    size_t size = sizeof(*header) + DEBUG_RING_COUNT * sizeof(*debug_rings);
+    LARGE_INTEGER counter, frequency;
+    char *name;
+    void *ptr;
+    int fd;
+
+    if (!prefix || !prefix[0]) return;
+
+    if (asprintf( &name, "%s.%d", prefix, (int)getpid() ) == -1) return;
+    fd = open( name, O_RDWR | O_CREAT | O_TRUNC, 0666 );
+    if (fd == -1)
+    {
+        fprintf( stderr, "wine: failed to create debug ring %s\n", name );
+        free( name );
+        return;
+    }
+    free( name );
+    if (ftruncate( fd, size ) == -1 ||
+        (ptr = mmap( NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 )) == MAP_FAILED)
+    {
+        close( fd );
+        return;
+    }
+    close( fd );
+
+    NtQueryPerformanceCounter( &counter, &frequency );
+    header = ptr;
+    header->pid = getpid();
+    header->count = DEBUG_RING_COUNT;
+    header->size = DEBUG_RING_SIZE;
+    header->frequency = frequency.QuadPart;
+    header->version = DEBUG_RING_VERSION;
+    debug_rings = (struct debug_ring *)(header + 1);
+    WriteRelease( (LONG *)&header->magic, DEBUG_RING_MAGIC );
+}
+
+/***********************************************************************
+ *		dbg_thread_exit
+ *
+ * Give back the trace ring of an exiting thread.
+ */
+void dbg_thread_exit(void)
+{
+    struct ntdll_thread_data *thread_data = ntdll_get_thread_data();
+
+    if (!thread_data->debug_ring) return;
+    WriteRelease( &debug_rings[thread_data->debug_ring - 1].owner, 0 );
+    thread_data->debug_ring = 0;
+}
+
 /***********************************************************************
  *		dbg_init
  */
@@ -366,6 +537,7 @@ void dbg_init(void)
     free( debug_options );
     debug_options = options;
     options[nb_debug_options] = default_option;
+    init_debug_rings();
     init_done = TRUE;
 }
 
@@ -1018,6 +1018,7 @@ static const unixlib_entry_t unix_call_funcs[] =
     unixcall_wine_server_handle_to_fd,
     unixcall_wine_spawnvp,
     system_time_precise,
+    prefetch_dll,
 };
 
 
@@ -1036,6 +1037,7 @@ const unixlib_entry_t unix_call_wow64_funcs[] =
     wow64_wine_server_handle_to_fd,
     wow64_wine_spawnvp,
     system_time_precise,
+    wow64_prefetch_dll,
 };
 
 #endif  /* _WIN64 */
@@ -1245,6 +1247,153 @@ done:
 }
 
 
+/***********************************************************************
+ *           prefetch_unix_file
+ */
+static BOOL prefetch_unix_file( const char *name )
+{
+    int fd;
+
+    if ((fd = open( name, O_RDONLY )) == -1) return FALSE;
+#ifdef HAVE_POSIX_FADVISE
+    posix_fadvise( fd, 0, 0, POSIX_FADV_WILLNEED );
+#endif
+    close( fd );
+    return TRUE;
+}
+
+
+/***********************************************************************
+ *           prefetch_builtin_dll
+ *
+ * Prefetch the PE file that find_builtin_dll would map for a builtin placeholder.
+ */
+static void prefetch_builtin_dll( const UNICODE_STRING *nt_name, USHORT machine )
+{
+    unsigned int i, pos, len, namepos = 0, maxlen = 0;
+    const char *pe_dir = get_pe_dir( machine );
+    const char *pe_build_dir = build_dir;
+    char *ptr, *file;
+
+    len = nt_name->Length / sizeof(WCHAR);
+    for (i = 0; i < len; i++)
+        if (nt_name->Buffer[i] == '/' || nt_name->Buffer[i] == '\\') namepos = i + 1;
+    len -= namepos;
+    if (!len) return;
+
+    if (build_dir)
+    {
+        if (alt_build_dir && machine == get_alt_machine( current_machine ))
+            pe_build_dir = alt_build_dir;
+        maxlen = max( strlen(build_dir), strlen(pe_build_dir) ) + sizeof("/programs/") + len;
+    }
+    maxlen = max( maxlen, dll_path_maxlen + 1 ) + len + sizeof("/aarch64-windows");
+
+    if (!(file = malloc( maxlen ))) return;
+
+    pos = maxlen - len - 1;
+    for (i = 0; i < len; i++)
+    {
+        WCHAR ch = nt_name->Buffer[namepos + i];
+        if (ch > 127) goto done;
+        if (ch >= 'A' && ch <= 'Z') ch += 'a' - 'A';
+        file[pos + i] = (char)ch;
+    }
+    file[pos + len] = 0;
+    file[--pos] = '/';
+
+    if (build_dir)
+    {
+        ptr = prepend_build_dir_path( file + pos, ".dll", pe_dir, "/dlls", pe_build_dir );
+        if (prefetch_unix_file( ptr )) goto done;
+        ptr = prepend_build_dir_path( file + pos, ".exe", pe_dir, "/programs", pe_build_dir );
+        if (prefetch_unix_file( ptr )) goto done;
+    }
+
+    for (i = 0; dll_paths[i]; i++)
+    {
+        ptr = prepend( file + pos, pe_dir, strlen(pe_dir) );
+        ptr = prepend( ptr, dll_paths[i], strlen(dll_paths[i]) );
+        if (prefetch_unix_file( ptr )) break;
+        ptr = prepend( file + pos, dll_paths[i], strlen(dll_paths[i]) );
+        if (prefetch_unix_file( ptr )) break;
+    }
+done:
+    free( file );
+}
+
+
+/***********************************************************************
+ *           prefetch_dll
+ *
+ * Start reading the file that will be mapped for a dll found by the loader search,
+ * without any server round trip. For Wine builtins this is the file in the lib dir.
+ */
+NTSTATUS prefetch_dll( void *args )
+{
+    static const char builtin_signature[] = "Wine builtin DLL";
+    static const char fakedll_signature[] = "Wine placeholder DLL";
+    const struct prefetch_dll_params *params = args;
+    UNICODE_STRING nt_name, true_nt_name;
+    OBJECT_ATTRIBUTES attr;
+    struct
+    {
+        IMAGE_DOS_HEADER dos;
+        char buffer[32];
+    } mz;
+    char *unix_name;
+    NTSTATUS status;
+    int fd;
+
+    init_unicode_string( &nt_name, params->nt_name );
+    InitializeObjectAttributes( &attr, &nt_name, OBJ_CASE_INSENSITIVE, 0, NULL );
+    if ((status = get_nt_and_unix_names( &attr, &true_nt_name, &unix_name, FILE_OPEN, FALSE )))
+        return status;
+
+    if ((fd = open( unix_name, O_RDONLY )) != -1)
+    {
+        if (pread( fd, &mz, sizeof(mz), 0 ) == sizeof(mz) &&
+            (!memcmp( mz.buffer, builtin_signature, sizeof(builtin_signature) ) ||
+             !memcmp( mz.buffer, fakedll_signature, sizeof(fakedll_signature) )))
+        {
+            prefetch_builtin_dll( &true_nt_name, params->machine );
+        }
+        else
+        {
+#ifdef HAVE_POSIX_FADVISE
+            posix_fadvise( fd, 0, 0, POSIX_FADV_WILLNEED );
+#endif
+        }
+        close( fd );
+    }
+    else status = STATUS_DLL_NOT_FOUND;
+
+    free( unix_name );
+    free( true_nt_name.Buffer );
+    return status;
+}
+
+
+#ifdef _WIN64
+
+/***********************************************************************
+ *           wow64_prefetch_dll
+ */
+NTSTATUS wow64_prefetch_dll( void *args )
+{
+    struct
+    {
+        ULONG  nt_name;
+        USHORT machine;
+    } const *params32 = args;
+    struct prefetch_dll_params params = { ULongToPtr( params32->nt_name ), params32->machine };
+
+    return prefetch_dll( &params );
+}
+
+#endif  /* _WIN64 */
+
+
 /***********************************************************************
  *           load_builtin
  *
@@ -1863,6 +2012,7 @@ static void start_main_thread(void)
 
     signal_init_threading();
     dbg_init();
+    init_syscall_profile();
     startup_info_size = server_init_process();
     virtual_map_user_shared_data();
     init_cpu_info();
@@ -2249,6 +2399,7 @@ DECLSPEC_EXPORT void __wine_main( int argc, char *argv[] )
 
     virtual_init();
     init_environment();
+    init_fork_server();
 
 #ifdef __APPLE__
     apple_main_thread();
@@ -70,6 +70,13 @@
 #include "wine/server.h"
 #include "wine/debug.h"
 
+#ifdef __APPLE__
+# include <crt_externs.h>
+# define environ (*_NSGetEnviron())
+#else
+  extern char **environ;
+#endif
+
 WINE_DEFAULT_DEBUG_CHANNEL(process);
 
 
@@ -397,6 +404,331 @@ static BOOL is_unix_console_handle( HANDLE handle )
 }
 
 
+/* The fork server is a small helper process forked at startup, before the address
+ * space gets large. New processes are forked from it instead of from the current
+ * process, which avoids copying the page tables of a fully initialized process.
+ * The Unix environment, the current directory and the stdio fds are sent along with
+ * each request. Other process state, like the umask, the resource limits or the fds
+ * opened without close-on-exec after startup, is the one of the fork server, that is
+ * of the parent process at the time it was started. */
+
+struct fork_server_request
+{
+    struct pe_image_info pe_info;        /* image info for exec_wineloader */
+    unsigned int         flags;          /* FORK_SERVER_* flags */
+    unsigned int         winedebug_len;  /* length of the WINEDEBUG string, including the null */
+    unsigned int         cmdline_len;    /* length of the command line in bytes */
+    unsigned int         env_len;        /* length of the Unix environment strings */
+    /* VARARG(winedebug,string,winedebug_len); */
+    /* VARARG(cmdline,unicode_str,cmdline_len); */
+    /* VARARG(env,strings,env_len); */
+};
+
+#define FORK_SERVER_SETSID   0x01  /* start a new session without stdio */
+#define FORK_SERVER_STDIN    0x02  /* an stdin fd follows the server socket fd */
+#define FORK_SERVER_STDOUT   0x04  /* an stdout fd follows */
+#define FORK_SERVER_STDERR   0x08  /* an stderr fd follows */
+#define FORK_SERVER_UNIXDIR  0x10  /* a current directory fd follows */
+#define FORK_SERVER_MAX_FDS  5
+
+static int fork_server_fd = -1;
+static pthread_mutex_t fork_server_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* read or write a full buffer on the fork server socket */
+static BOOL fork_server_io( int fd, void *buffer, size_t size, BOOL write_data )
+{
+    char *ptr = buffer;
+    ssize_t ret;
+
+    while (size)
+    {
+        ret = write_data ? write( fd, ptr, size ) : read( fd, ptr, size );
+        if (ret > 0)
+        {
+            ptr += ret;
+            size -= ret;
+        }
+        else if (!ret || errno != EINTR) return FALSE;
+    }
+    return TRUE;
+}
+
+
+/***********************************************************************
+ *           fork_server_set_environ
+ *
+ * Replace the environment with the strings sent by the parent process.
+ */
+static void fork_server_set_environ( char *env, unsigned int size )
+{
+    char **envp, *p, *end = env + size;
+    unsigned int count = 0;
+
+    end[-1] = 0;
+    for (p = env; p < end; p += strlen( p ) + 1) count++;
+    if (!(envp = malloc( (count + 1) * sizeof(*envp) ))) return;
+    for (p = env, count = 0; p < end; p += strlen( p ) + 1) envp[count++] = p;
+    envp[count] = NULL;
+    environ = envp;
+}
+
+
+/***********************************************************************
+ *           fork_server_exec
+ *
+ * Set up the new process in the child of the fork server and exec the loader.
+ */
+static void fork_server_exec( const struct fork_server_request *req, char *data,
+                              const int fds[FORK_SERVER_MAX_FDS] )
+{
+    int socketfd = fds[0], stdin_fd = fds[1], stdout_fd = fds[2], stderr_fd = fds[3], unixdir = fds[4];
+    UNICODE_STRING cmdline;
+    char **argv;
+
+    signal( SIGCHLD, SIG_DFL );
+
+    if (stderr_fd != -1 && stderr_fd != 2)
+    {
+        dup2( stderr_fd, 2 );
+        close( stderr_fd );
+    }
+    if (req->env_len) fork_server_set_environ( data + req->winedebug_len + req->cmdline_len, req->env_len );
+
+    if (req->flags & FORK_SERVER_SETSID)
+    {
+        setsid();
+        set_stdio_fd( -1, -1 );  /* close stdin and stdout */
+    }
+    else set_stdio_fd( stdin_fd, stdout_fd );
+
+    if (stdin_fd != -1 && stdin_fd != 0) close( stdin_fd );
+    if (stdout_fd != -1 && stdout_fd != 1) close( stdout_fd );
+
+    if (req->winedebug_len) putenv( data );
+    if (unixdir != -1)
+    {
+        fchdir( unixdir );
+        close( unixdir );
+    }
+    cmdline.Buffer = (WCHAR *)(data + req->winedebug_len);
+    cmdline.Length = cmdline.MaximumLength = req->cmdline_len;
+    argv = build_argv( &cmdline, 2 );
+
+    exec_wineloader( argv, socketfd, &req->pe_info );
+    _exit(1);
+}
+
+
+/***********************************************************************
+ *           fork_server_main
+ *
+ * Main loop of the fork server process.
+ */
+static void fork_server_main( int fd )
+{
+    struct fork_server_request req;
+    struct cmsghdr *cmsg;
+    struct msghdr msghdr;
+    struct iovec vec;
+    char cmsg_buffer[256];
+    char *data;
+    int i, count, ret, fds[FORK_SERVER_MAX_FDS], recv_fds[FORK_SERVER_MAX_FDS];
+    pid_t pid;
+
+    signal( SIGCHLD, SIG_IGN );  /* let the system reap the children */
+
+    for (;;)
+    {
+        msghdr.msg_name    = NULL;
+        msghdr.msg_namelen = 0;
+        msghdr.msg_iov     = &vec;
+        msghdr.msg_iovlen  = 1;
+        msghdr.msg_control = cmsg_buffer;
+        msghdr.msg_controllen = sizeof(cmsg_buffer);
+        msghdr.msg_flags   = 0;
+
+        vec.iov_base = (void *)&req;
+        vec.iov_len  = sizeof(req);
+
+        if ((ret = recvmsg( fd, &msghdr, 0 )) <= 0)
+        {
+            if (ret == -1 && errno == EINTR) continue;
+            _exit(0);  /* the parent process is gone */
+        }
+
+        count = 0;
+        for (cmsg = CMSG_FIRSTHDR( &msghdr ); cmsg; cmsg = CMSG_NXTHDR( &msghdr, cmsg ))
+        {
+            if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS) continue;
+            for (i = 0; i < (int)((cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int)); i++)
+            {
+                int recv_fd = ((int *)CMSG_DATA(cmsg))[i];
+
+                if (count < ARRAY_SIZE(recv_fds)) recv_fds[count++] = recv_fd;
+                else close( recv_fd );  /* don't leak unexpected fds */
+            }
+        }
+        if (ret < sizeof(req) && !fork_server_io( fd, (char *)&req + ret, sizeof(req) - ret, FALSE ))
+            _exit(1);
+
+        i = 0;
+        fds[0] = i < count ? recv_fds[i++] : -1;
+        fds[1] = (req.flags & FORK_SERVER_STDIN) && i < count ? recv_fds[i++] : -1;
+        fds[2] = (req.flags & FORK_SERVER_STDOUT) && i < count ? recv_fds[i++] : -1;
+        fds[3] = (req.flags & FORK_SERVER_STDERR) && i < count ? recv_fds[i++] : -1;
+        fds[4] = (req.flags & FORK_SERVER_UNIXDIR) && i < count ? recv_fds[i++] : -1;
+
+        if (!(data = malloc( req.winedebug_len + req.cmdline_len + req.env_len + sizeof(WCHAR) )) ||
+            !fork_server_io( fd, data, req.winedebug_len + req.cmdline_len + req.env_len, FALSE ))
+            _exit(1);
+
+        if (fds[0] == -1) ret = EBADF;
+        else if (!(pid = fork())) fork_server_exec( &req, data, fds );
+        else ret = (pid == -1) ? errno : 0;
+        for (i = 0; i < count; i++) close( recv_fds[i] );
+        free( data );
+        if (!fork_server_io( fd, &ret, sizeof(ret), TRUE )) _exit(1);
+    }
+}
+
+
+/***********************************************************************
+ *           init_fork_server
+ *
+ * Start the fork server if enabled with WINEFORKSERVER.
+ */
+void init_fork_server(void)
+{
+    const char *env = getenv( "WINEFORKSERVER" );
+    int fds[2];
+    pid_t pid;
+
+    if (!env || !atoi( env )) return;
+
+    if (socketpair( PF_UNIX, SOCK_STREAM, 0, fds ) == -1) return;
+    fcntl( fds[0], F_SETFD, FD_CLOEXEC );
+    fcntl( fds[1], F_SETFD, FD_CLOEXEC );
+
+    if (!(pid = fork()))
+    {
+        close( fds[0] );
+        fork_server_main( fds[1] );
+    }
+    close( fds[1] );
+    if (pid == -1) close( fds[0] );
+    else fork_server_fd = fds[0];
+}
+
+
+/***********************************************************************
+ *           fork_server_spawn
+ *
+ * Ask the fork server to start the new process.
+ * Returns FALSE if the fork server is not available.
+ */
+static BOOL fork_server_spawn( const RTL_USER_PROCESS_PARAMETERS *params, int socketfd, int unixdir,
+                               int stdin_fd, int stdout_fd, BOOL detach, const char *winedebug,
+                               const struct pe_image_info *pe_info, NTSTATUS *status )
+{
+    struct fork_server_request req;
+    struct msghdr msghdr;
+    struct cmsghdr *cmsg;
+    struct iovec vec;
+    char cmsg_buffer[CMSG_SPACE( FORK_SERVER_MAX_FDS * sizeof(int) )];
+    int fds[FORK_SERVER_MAX_FDS], count = 0, cwd = -1, err, ret;
+    char **e, *env, *p;
+    BOOL ok = FALSE;
+
+    if (fork_server_fd == -1) return FALSE;
+
+    memset( &req, 0, sizeof(req) );
+    req.pe_info = *pe_info;
+    req.winedebug_len = winedebug ? strlen( winedebug ) + 1 : 0;
+    req.cmdline_len = params->CommandLine.Length;
+
+    /* the environment may have changed since the fork server was started */
+    for (e = environ; *e; e++) req.env_len += strlen( *e ) + 1;
+    if (!(env = malloc( req.env_len + 1 ))) return FALSE;
+    for (e = environ, p = env; *e; e++)
+    {
+        size_t len = strlen( *e ) + 1;
+        memcpy( p, *e, len );
+        p += len;
+    }
+
+    fds[count++] = socketfd;
+    if (detach) req.flags |= FORK_SERVER_SETSID;
+    else
+    {
+        if (stdin_fd != -1)
+        {
+            req.flags |= FORK_SERVER_STDIN;
+            fds[count++] = stdin_fd;
+        }
+        if (stdout_fd != -1)
+        {
+            req.flags |= FORK_SERVER_STDOUT;
+            fds[count++] = stdout_fd;
+        }
+    }
+    if (fcntl( 2, F_GETFD ) != -1)
+    {
+        req.flags |= FORK_SERVER_STDERR;
+        fds[count++] = 2;
+    }
+    /* without a dos directory the child inherits our current unix directory */
+    if (unixdir == -1) unixdir = cwd = open( ".", O_RDONLY );
+    if (unixdir != -1)
+    {
+        req.flags |= FORK_SERVER_UNIXDIR;
+        fds[count++] = unixdir;
+    }
+
+    msghdr.msg_name    = NULL;
+    msghdr.msg_namelen = 0;
+    msghdr.msg_iov     = &vec;
+    msghdr.msg_iovlen  = 1;
+    msghdr.msg_control = cmsg_buffer;
+    msghdr.msg_controllen = sizeof(cmsg_buffer);
+    msghdr.msg_flags   = 0;
+
+    vec.iov_base = (void *)&req;
+    vec.iov_len  = sizeof(req);
+
+    cmsg = CMSG_FIRSTHDR( &msghdr );
+    cmsg->cmsg_len   = CMSG_LEN( count * sizeof(int) );
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type  = SCM_RIGHTS;
+    memcpy( CMSG_DATA(cmsg), fds, count * sizeof(int) );
+    msghdr.msg_controllen = cmsg->cmsg_len;
+
+    mutex_lock( &fork_server_mutex );
+    if (fork_server_fd != -1)
+    {
+        while ((ret = sendmsg( fork_server_fd, &msghdr, 0 )) == -1 && errno == EINTR);
+        if (ret == sizeof(req) &&
+            fork_server_io( fork_server_fd, (void *)winedebug, req.winedebug_len, TRUE ) &&
+            fork_server_io( fork_server_fd, params->CommandLine.Buffer, req.cmdline_len, TRUE ) &&
+            fork_server_io( fork_server_fd, env, req.env_len, TRUE ) &&
+            fork_server_io( fork_server_fd, &err, sizeof(err), FALSE ))
+        {
+            *status = err ? STATUS_NO_MEMORY : STATUS_SUCCESS;
+            ok = TRUE;
+        }
+        else
+        {
+            WARN( "fork server failed, falling back to fork\n" );
+            close( fork_server_fd );
+            fork_server_fd = -1;
+        }
+    }
+    mutex_unlock( &fork_server_mutex );
+    if (cwd != -1) close( cwd );
+    free( env );
+    return ok;
+}
+
+
 /***********************************************************************
  *           spawn_process
  */
@@ -405,6 +737,7 @@ static NTSTATUS spawn_process( const RTL_USER_PROCESS_PARAMETERS *params, int so
 {
     NTSTATUS status = STATUS_SUCCESS;
     int stdin_fd = -1, stdout_fd = -1;
+    BOOL detach;
     pid_t pid;
     char **argv;
 
@@ -416,14 +749,20 @@ static NTSTATUS spawn_process( const RTL_USER_PROCESS_PARAMETERS *params, int so
         isatty(1) && is_unix_console_handle( params->hStdOutput ))
         stdout_fd = 1;
 
+    detach = (peb->ProcessParameters && params->ProcessGroupId != peb->ProcessParameters->ProcessGroupId) ||
+             params->ConsoleHandle == CONSOLE_HANDLE_ALLOC ||
+             params->ConsoleHandle == CONSOLE_HANDLE_ALLOC_NO_WINDOW ||
+             params->ConsoleHandle == NULL;
+
+    if (fork_server_spawn( params, socketfd, unixdir, stdin_fd, stdout_fd, detach,
+                           winedebug, pe_info, &status ))
+        goto done;
+
     if (!(pid = fork()))  /* child */
     {
         if (!(pid = fork()))  /* grandchild */
         {
-            if ((peb->ProcessParameters && params->ProcessGroupId != peb->ProcessParameters->ProcessGroupId) ||
-                params->ConsoleHandle == CONSOLE_HANDLE_ALLOC ||
-                params->ConsoleHandle == CONSOLE_HANDLE_ALLOC_NO_WINDOW ||
-                params->ConsoleHandle == NULL)
+            if (detach)
             {
                 setsid();
                 set_stdio_fd( -1, -1 );  /* close stdin and stdout */
@@ -458,6 +797,7 @@ static NTSTATUS spawn_process( const RTL_USER_PROCESS_PARAMETERS *params, int so
     }
     else status = STATUS_NO_MEMORY;
 
+done:
     if (stdin_fd != -1 && stdin_fd != 0) close( stdin_fd );
     if (stdout_fd != -1 && stdout_fd != 1) close( stdout_fd );
     return status;
@@ -809,8 +809,20 @@ NTSTATUS WINAPI NtSaveKey( HANDLE key, HANDLE file )
  */
 NTSTATUS WINAPI NtRestoreKey( HANDLE key, HANDLE file, ULONG flags )
 {
-    FIXME( "(%p,%p,0x%08x) stub\n", key, file, flags );
-    return STATUS_SUCCESS;
+    unsigned int ret;
+
+    TRACE( "(%p,%p,0x%08x)\n", key, file, flags );
+
+    if (flags) FIXME( "flags %#x not supported\n", flags );
+
+    SERVER_START_REQ( restore_registry )
+    {
+        req->hkey = wine_server_obj_handle( key );
+        req->file = wine_server_obj_handle( file );
+        ret = wine_server_call( req );
+    }
+    SERVER_END_REQ;
+    return ret;
 }
 
 
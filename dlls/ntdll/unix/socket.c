@@ -42,6 +42,9 @@
 #ifdef HAVE_NETINET_TCP_H
 # include <netinet/tcp.h>
 #endif
+#ifdef __linux__
+# include <sys/sendfile.h>
+#endif
 
 #ifdef HAVE_NETIPX_IPX_H
 # include <netipx/ipx.h>
@@ -130,6 +133,8 @@ struct async_send_ioctl
     unsigned int count;
     unsigned int iov_cursor;
     int fd;
+    unsigned short sock_type;
+    BOOL icmp_over_dgram;
     struct iovec iov[1];
 };
 
@@ -146,6 +151,7 @@ struct async_transmit_ioctl
     unsigned int tail_cursor;   /* amount of tail data already sent */
     unsigned int file_len;      /* total file length to send */
     unsigned int flags;
+    BOOL copy_file;             /* file data can't be sent with sendfile() */
     const char *head;
     const char *tail;
     unsigned int head_len;
@@ -894,23 +900,6 @@ static BOOL async_recv_proc( void *user, ULONG_PTR *info, unsigned int *status )
     return TRUE;
 }
 
-static BOOL is_icmp_over_dgram( int fd )
-{
-#ifdef linux
-    socklen_t len;
-    int val;
-
-    len = sizeof(val);
-    if (getsockopt( fd, SOL_SOCKET, SO_PROTOCOL, (char *)&val, &len ) || (val != IPPROTO_ICMP && val != IPPROTO_ICMPV6))
-        return FALSE;
-
-    len = sizeof(val);
-    return !getsockopt( fd, SOL_SOCKET, SO_TYPE, (char *)&val, &len ) && val == SOCK_DGRAM;
-#else
-    return FALSE;
-#endif
-}
-
 static NTSTATUS sock_recv( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, void *apc_user, IO_STATUS_BLOCK *io,
                            int fd, struct async_recv_ioctl *async, int force_async )
 {
@@ -937,6 +926,7 @@ static NTSTATUS sock_recv( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, voi
         wait_handle = wine_server_ptr_handle( reply->wait );
         options     = reply->options;
         nonblocking = reply->nonblocking;
+        async->icmp_over_dgram = reply->icmp_over_dgram;
     }
     SERVER_END_REQ;
 
@@ -1008,7 +998,6 @@ static NTSTATUS sock_ioctl_recv( HANDLE handle, HANDLE event, PIO_APC_ROUTINE ap
     async->addr = addr;
     async->addr_len = addr_len;
     async->ret_flags = ret_flags;
-    async->icmp_over_dgram = is_icmp_over_dgram( fd );
 
     return sock_recv( handle, event, apc, apc_user, io, fd, async, force_async );
 }
@@ -1031,7 +1020,6 @@ NTSTATUS sock_read( HANDLE handle, int fd, HANDLE event, PIO_APC_ROUTINE apc,
     async->addr = NULL;
     async->addr_len = NULL;
     async->ret_flags = NULL;
-    async->icmp_over_dgram = is_icmp_over_dgram( fd );
 
     return sock_recv( handle, event, apc, apc_user, io, fd, async, 1 );
 }
@@ -1042,14 +1030,10 @@ static NTSTATUS try_send( int fd, struct async_send_ioctl *async )
     union unix_sockaddr unix_addr;
     struct msghdr hdr;
     int attempt = 0;
-    int sock_type;
-    socklen_t len = sizeof(sock_type);
     ssize_t ret;
 
-    getsockopt(fd, SOL_SOCKET, SO_TYPE, &sock_type, &len);
-
     memset( &hdr, 0, sizeof(hdr) );
-    if (async->addr && sock_type != SOCK_STREAM)
+    if (async->addr && async->sock_type != WS_SOCK_STREAM)
     {
         hdr.msg_name = &unix_addr;
         hdr.msg_namelen = sockaddr_to_unix( async->addr, async->addr_len, &unix_addr );
@@ -1058,7 +1042,8 @@ static NTSTATUS try_send( int fd, struct async_send_ioctl *async )
             ERR( "failed to convert address\n" );
             return STATUS_ACCESS_VIOLATION;
         }
-        if (sock_type == SOCK_DGRAM && ((unix_addr.addr.sa_family == AF_INET && !unix_addr.in.sin_port)
+        if ((async->sock_type == WS_SOCK_DGRAM || async->icmp_over_dgram)
+            && ((unix_addr.addr.sa_family == AF_INET && !unix_addr.in.sin_port)
             || (unix_addr.addr.sa_family == AF_INET6 && !unix_addr.in6.sin6_port)))
         {
             /* Sending to port 0 succeeds on Windows. Use 'discard' service instead so sendmsg() works on Unix
@@ -1194,13 +1179,15 @@ static NTSTATUS sock_send( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, voi
         wait_handle = wine_server_ptr_handle( reply->wait );
         options     = reply->options;
         nonblocking = reply->nonblocking;
+        async->sock_type = reply->type;
+        async->icmp_over_dgram = reply->icmp_over_dgram;
     }
     SERVER_END_REQ;
 
     /* the server currently will never succeed immediately */
     assert(status == STATUS_ALERTED || status == STATUS_PENDING || NT_ERROR(status));
 
-    if (!NT_ERROR(status) && is_icmp_over_dgram( fd ))
+    if (!NT_ERROR(status) && async->icmp_over_dgram)
         sock_save_icmp_id( async );
 
     if (status == STATUS_ALERTED)
@@ -1361,15 +1348,67 @@ static ssize_t do_send( int fd, const void *buffer, size_t len, int flags )
     return ret;
 }
 
+#ifdef __linux__
+/* send file data straight from the page cache, without copying it through the buffer */
+static NTSTATUS try_sendfile( int sock_fd, int file_fd, struct async_transmit_ioctl *async )
+{
+    ssize_t ret;
+    off_t offset;
+
+    while (async->file)
+    {
+        size_t count = 0x7ffff000;
+
+        if (async->file_len)
+            count = min( count, async->file_len - async->file_cursor );
+
+        TRACE( "sending %zu bytes of file data\n", count );
+        if (async->offset.QuadPart == FILE_USE_FILE_POINTER_POSITION)
+            while ((ret = sendfile( sock_fd, file_fd, NULL, count )) < 0 && errno == EINTR);
+        else
+        {
+            offset = async->offset.QuadPart;
+            while ((ret = sendfile( sock_fd, file_fd, &offset, count )) < 0 && errno == EINTR);
+        }
+        if (ret < 0)
+        {
+            if (errno == EINVAL || errno == ENOSYS)
+            {
+                TRACE( "sendfile not supported, falling back to copying\n" );
+                async->copy_file = TRUE;
+                return STATUS_SUCCESS;
+            }
+            if (errno != EWOULDBLOCK) WARN( "sendfile: %s\n", strerror( errno ) );
+            return sock_errno_to_status( errno );
+        }
+        TRACE( "sendfile returned %zd\n", ret );
+
+        async->file_cursor += ret;
+        if (async->offset.QuadPart != FILE_USE_FILE_POINTER_POSITION)
+            async->offset.QuadPart += ret;
+        if (!ret || (async->file_len && async->file_cursor == async->file_len))
+            async->file = NULL;
+    }
+    return STATUS_SUCCESS;
+}
+#endif
+
 static NTSTATUS try_transmit( int sock_fd, int file_fd, struct async_transmit_ioctl *async )
 {
+    int flags = 0;
     ssize_t ret;
 
+#ifdef MSG_MORE
+    /* let the header go out in the same segments as the data following it;
+     * only safe when the tail is there to flush it, the file might be empty */
+    if (async->tail_len) flags |= MSG_MORE;
+#endif
+
     while (async->head_cursor < async->head_len)
     {
         TRACE( "sending %u bytes of header data\n", async->head_len - async->head_cursor );
         ret = do_send( sock_fd, async->head + async->head_cursor,
-                       async->head_len - async->head_cursor, 0 );
+                       async->head_len - async->head_cursor, flags );
         if (ret < 0) return sock_errno_to_status( errno );
         TRACE( "send returned %zd\n", ret );
         async->head_cursor += ret;
@@ -1386,6 +1425,14 @@ static NTSTATUS try_transmit( int sock_fd, int file_fd, struct async_transmit_io
         async->file_cursor += ret;
     }
 
+#ifdef __linux__
+    if (async->file && !async->copy_file && async->buffer_cursor == async->read_len)
+    {
+        NTSTATUS status = try_sendfile( sock_fd, file_fd, async );
+        if (status) return status;
+    }
+#endif
+
     if (async->file && async->buffer_cursor == async->read_len)
     {
         unsigned int read_size = async->buffer_size;
@@ -1505,6 +1552,7 @@ static NTSTATUS sock_transmit( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc,
     async->tail_cursor = 0;
     async->file_len = params->file_len;
     async->flags = params->flags;
+    async->copy_file = FALSE;
     async->head = u64_to_user_ptr(params->head_ptr);
     async->head_len = params->head_len;
     async->tail = u64_to_user_ptr(params->tail_ptr);
@@ -2872,9 +2872,10 @@ NTSTATUS WINAPI NtRemoveIoCompletion( HANDLE handle, ULONG_PTR *key, ULONG_PTR *
 NTSTATUS WINAPI NtRemoveIoCompletionEx( HANDLE handle, FILE_IO_COMPLETION_INFORMATION *info, ULONG count,
                                         ULONG *written, LARGE_INTEGER *timeout, BOOLEAN alertable )
 {
+    struct completion_msg msgs[64];
     HANDLE wait_handle = NULL;
     unsigned int status;
-    ULONG i = 0;
+    ULONG i = 0, j, max_extra, extra;
 
     TRACE( "%p %p %u %p %p %u\n", handle, info, count, written, timeout, alertable );
 
@@ -2882,22 +2883,36 @@ NTSTATUS WINAPI NtRemoveIoCompletionEx( HANDLE handle, FILE_IO_COMPLETION_INFORM
 
     while (i < count)
     {
+        /* the server returns further queued entries along with the first one */
+        max_extra = min( count - i - 1, ARRAY_SIZE(msgs) );
+        extra = 0;
         SERVER_START_REQ( remove_completion )
         {
             req->handle = wine_server_obj_handle( handle );
             req->alertable = alertable;
+            if (max_extra) wine_server_set_reply( req, msgs, max_extra * sizeof(*msgs) );
             if (!(status = wine_server_call( req )))
             {
                 info[i].CompletionKey             = reply->ckey;
                 info[i].CompletionValue           = reply->cvalue;
                 info[i].IoStatusBlock.Information = reply->information;
                 info[i].IoStatusBlock.Status      = reply->status;
+                extra = wine_server_reply_size( reply ) / sizeof(*msgs);
             }
             else wait_handle = wine_server_ptr_handle( reply->wait_handle );
         }
         SERVER_END_REQ;
         if (status != STATUS_SUCCESS) break;
         ++i;
+        for (j = 0; j < extra; j++, i++)
+        {
+            info[i].CompletionKey             = msgs[j].ckey;
+            info[i].CompletionValue           = msgs[j].cvalue;
+            info[i].IoStatusBlock.Information = msgs[j].information;
+            info[i].IoStatusBlock.Status      = msgs[j].status;
+        }
+        /* a short batch means the queue is drained */
+        if (extra < max_extra) break;
     }
     if (i || (status != STATUS_PENDING && status != STATUS_USER_APC))
     {
@@ -2914,18 +2929,29 @@ NTSTATUS WINAPI NtRemoveIoCompletionEx( HANDLE handle, FILE_IO_COMPLETION_INFORM
     else                               status = STATUS_TIMEOUT;
     if (status != WAIT_OBJECT_0) goto done;
 
+    max_extra = min( count - 1, ARRAY_SIZE(msgs) );
+    extra = 0;
     SERVER_START_REQ( get_thread_completion )
     {
+        if (max_extra) wine_server_set_reply( req, msgs, max_extra * sizeof(*msgs) );
         if (!(status = wine_server_call( req )))
         {
             info[i].CompletionKey             = reply->ckey;
             info[i].CompletionValue           = reply->cvalue;
             info[i].IoStatusBlock.Information = reply->information;
             info[i].IoStatusBlock.Status      = reply->status;
+            extra = wine_server_reply_size( reply ) / sizeof(*msgs);
             ++i;
         }
     }
     SERVER_END_REQ;
+    for (j = 0; j < extra; j++, i++)
+    {
+        info[i].CompletionKey             = msgs[j].ckey;
+        info[i].CompletionValue           = msgs[j].cvalue;
+        info[i].IoStatusBlock.Information = msgs[j].information;
+        info[i].IoStatusBlock.Status      = msgs[j].status;
+    }
 
 done:
     *written = i ? i : 1;
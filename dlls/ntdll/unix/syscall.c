@@ -24,8 +24,14 @@
 
 #include "config.h"
 
+#include <fcntl.h>
 #include <stdarg.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <unistd.h>
 
 #include "ntstatus.h"
 #include "windef.h"
@@ -275,11 +281,178 @@ BOOLEAN KeAddSystemServiceTable( ULONG_PTR *funcs, ULONG_PTR *counters, ULONG li
     return TRUE;
 }
 
+/*
+ * Syscall profiling, enabled by setting WINESYSCALLPROFILE to a file name prefix.
+ *
+ * Each process maps a file named "<prefix>.<unix pid>", made of a header
+ * followed by one array of entries per system service table, indexed by
+ * syscall number. The entries are updated with atomic operations every
+ * time a syscall returns, so the file can be read while the process is
+ * running. The name of an entry is filled the first time it's called.
+ */
+#define SYSCALL_PROFILE_MAGIC    0x666f7270  /* "prof" */
+#define SYSCALL_PROFILE_VERSION  1
+#define SYSCALL_PROFILE_TABLES   ARRAY_SIZE(KeServiceDescriptorTable)
+#define SYSCALL_PROFILE_ENTRIES  0x1000
+#define SYSCALL_PROFILE_BUCKETS  24
+
+struct syscall_profile_header
+{
+    UINT magic;            /* SYSCALL_PROFILE_MAGIC */
+    UINT version;          /* SYSCALL_PROFILE_VERSION */
+    UINT pid;              /* unix process id */
+    UINT tables;           /* number of service tables */
+    UINT entries;          /* number of entries per table */
+    UINT buckets;          /* number of histogram buckets */
+    UINT entry_size;       /* size of an entry */
+    UINT reserved;
+};
+
+struct syscall_profile_entry
+{
+    LONG64 count;          /* number of completed calls */
+    LONG64 total;          /* total time spent in the call, in nanoseconds */
+    LONG64 max;            /* longest call, in nanoseconds */
+    LONG64 histogram[SYSCALL_PROFILE_BUCKETS];  /* bucket n counts calls shorter than 2^(10+n) ns */
+    char   name[64];       /* syscall name */
+};
+
+static struct syscall_profile_entry *syscall_profile;
+
+/* syscalls that never return to the caller, and would leave stale frames behind */
+static const char * const profile_noreturn_names[] =
+{
+    "NtCallbackReturn", "NtContinue", "NtContinueEx", "NtRaiseException"
+};
+static UINT profile_noreturn[ARRAY_SIZE(profile_noreturn_names)];
+
+static inline ULONGLONG profile_time(void)
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec * (ULONGLONG)1000000000 + ts.tv_nsec;
+}
+
+/***********************************************************************
+ *           init_syscall_profile
+ */
+void init_syscall_profile(void)
+{
+    const char *prefix = getenv( "WINESYSCALLPROFILE" );
+    struct syscall_profile_header *header;
+    size_t size = sizeof(*header) + SYSCALL_PROFILE_TABLES * SYSCALL_PROFILE_ENTRIES * sizeof(*syscall_profile);
+    char *name;
+    void *ptr;
+    int fd;
+    UINT i, j;
+
+    if (!prefix || !prefix[0]) return;
+
+    for (i = 0; i < ARRAY_SIZE(profile_noreturn); i++)
+    {
+        profile_noreturn[i] = ~0u;
+        for (j = 0; j < ARRAY_SIZE(ntsyscall_names); j++)
+        {
+            if (strcmp( ntsyscall_names[j], profile_noreturn_names[i] )) continue;
+            profile_noreturn[i] = j;
+            break;
+        }
+    }
+
+    if (asprintf( &name, "%s.%d", prefix, (int)getpid() ) == -1) return;
+    fd = open( name, O_RDWR | O_CREAT | O_TRUNC, 0666 );
+    if (fd == -1)
+    {
+        fprintf( stderr, "wine: failed to create syscall profile %s\n", name );
+        free( name );
+        return;
+    }
+    free( name );
+    if (ftruncate( fd, size ) == -1 ||
+        (ptr = mmap( NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 )) == MAP_FAILED)
+    {
+        close( fd );
+        return;
+    }
+    close( fd );
+
+    header = ptr;
+    header->pid = getpid();
+    header->tables = SYSCALL_PROFILE_TABLES;
+    header->entries = SYSCALL_PROFILE_ENTRIES;
+    header->buckets = SYSCALL_PROFILE_BUCKETS;
+    header->entry_size = sizeof(*syscall_profile);
+    header->version = SYSCALL_PROFILE_VERSION;
+    syscall_profile = (struct syscall_profile_entry *)(header + 1);
+    WriteRelease( (LONG *)&header->magic, SYSCALL_PROFILE_MAGIC );
+}
+
+/***********************************************************************
+ *           is_syscall_traced
+ *
+ * Check whether the syscall dispatcher needs to call the trace functions.
+ */
+BOOL is_syscall_traced(void)
+{
+    return TRACE_ON(syscall) || syscall_profile;
+}
+
+static void profile_syscall( UINT id )
+{
+    struct ntdll_thread_data *thread_data = ntdll_get_thread_data();
+    int depth = thread_data->profile_depth;
+    UINT i;
+
+    for (i = 0; i < ARRAY_SIZE(profile_noreturn); i++) if (id == profile_noreturn[i]) return;
+    thread_data->profile_depth = depth + 1;
+    /* too deeply nested, the call is only counted in the depth and not profiled */
+    if (depth >= ARRAY_SIZE(thread_data->profile_frames)) return;
+    thread_data->profile_frames[depth].id = id;
+    thread_data->profile_frames[depth].start = profile_time();
+}
+
+static void profile_sysret( UINT id )
+{
+    struct ntdll_thread_data *thread_data = ntdll_get_thread_data();
+    struct syscall_profile_entry *entry;
+    UINT idx = (id >> 12) & 3, num = id & 0xfff;
+    const char **names = syscall_names[idx];
+    ULONGLONG time, max, t;
+    int depth = thread_data->profile_depth, bucket;
+
+    if (depth > ARRAY_SIZE(thread_data->profile_frames))
+    {
+        thread_data->profile_depth = depth - 1;
+        return;
+    }
+    while (depth && thread_data->profile_frames[depth - 1].id != id) depth--;
+    if (!depth) return;
+    thread_data->profile_depth = --depth;
+    time = profile_time() - thread_data->profile_frames[depth].start;
+
+    for (bucket = 0, t = time >> 10; t && bucket < SYSCALL_PROFILE_BUCKETS - 1; t >>= 1) bucket++;
+
+    entry = &syscall_profile[idx * SYSCALL_PROFILE_ENTRIES + num];
+    if (InterlockedIncrement64( &entry->count ) == 1)
+    {
+        if (names && names[num]) snprintf( entry->name, sizeof(entry->name), "%s", names[num] );
+        else snprintf( entry->name, sizeof(entry->name), "%04x", id );
+    }
+    InterlockedExchangeAdd64( &entry->total, time );
+    InterlockedIncrement64( &entry->histogram[bucket] );
+    max = entry->max;
+    while (time > max && InterlockedCompareExchange64( &entry->max, time, max ) != max) max = entry->max;
+}
+
 void trace_syscall( UINT id, ULONG_PTR *args, ULONG len )
 {
     UINT idx = (id >> 12) & 3, num = id & 0xfff;
     const char **names = syscall_names[idx];
 
+    if (syscall_profile) profile_syscall( id );
+    if (!TRACE_ON(syscall)) return;
+
     if (names && names[num])
         TRACE( "\1SysCall  %s(", names[num] );
     else
@@ -299,6 +472,8 @@ void trace_sysret( UINT id, ULONG_PTR retval )
     UINT idx = (id >> 12) & 3, num = id & 0xfff;
     const char **names = syscall_names[idx];
 
+    if (syscall_profile) profile_sysret( id );
+
     if (names && names[num])
         TRACE( "\1SysRet   %s() retval=%08lx\n", names[num], retval );
     else
@@ -98,6 +98,12 @@ static inline BOOL is_arm64ec(void)
             main_image_info.Machine == IMAGE_FILE_MACHINE_AMD64);
 }
 
+struct syscall_profile_frame
+{
+    UINT                      id;            /* syscall id */
+    ULONGLONG                 start;         /* start time */
+};
+
 /* thread private data, stored in NtCurrentTeb()->GdiTebBatch */
 struct ntdll_thread_data
 {
@@ -116,6 +122,9 @@ struct ntdll_thread_data
     PRTL_THREAD_START_ROUTINE start;         /* thread entry point */
     void                     *param;         /* thread entry point parameter */
     void                     *jmp_buf;       /* setjmp buffer for exception handling */
+    int                       debug_ring;    /* index + 1 of the debug trace ring, 0 if none */
+    int                       profile_depth; /* number of syscalls being profiled */
+    struct syscall_profile_frame profile_frames[8]; /* syscalls being profiled */
 };
 
 C_ASSERT( sizeof(struct ntdll_thread_data) <= sizeof(((TEB *)0)->GdiTebBatch) );
@@ -218,6 +227,7 @@ extern ULONG process_cookie;
 
 extern void init_environment(void);
 extern void init_startup_info(void);
+extern void init_fork_server(void);
 extern void *create_startup_info( const UNICODE_STRING *nt_image, ULONG process_flags,
                                   const RTL_USER_PROCESS_PARAMETERS *params,
                                   const struct pe_image_info *pe_info, DWORD *info_size );
@@ -284,6 +294,7 @@ extern NTSTATUS get_thread_context( HANDLE handle, void *context, BOOL *self, US
 extern unsigned int alloc_object_attributes( const OBJECT_ATTRIBUTES *attr, struct object_attributes **ret,
                                              data_size_t *ret_len );
 extern NTSTATUS system_time_precise( void *args );
+extern NTSTATUS prefetch_dll( void *args );
 
 extern void *anon_mmap_fixed( void *start, size_t size, int prot, int flags );
 extern void *anon_mmap_alloc( size_t size, int prot );
@@ -339,6 +350,8 @@ extern void signal_init_process(void);
 extern void DECLSPEC_NORETURN signal_start_thread( PRTL_THREAD_START_ROUTINE entry, void *arg,
                                                    BOOL suspend, TEB *teb );
 extern SYSTEM_SERVICE_TABLE KeServiceDescriptorTable[4];
+extern void init_syscall_profile(void);
+extern BOOL is_syscall_traced(void);
 extern void __wine_syscall_dispatcher(void);
 extern void __wine_syscall_dispatcher_return(void);
 extern void __wine_unix_call_dispatcher(void);
@@ -398,9 +411,11 @@ extern NTSTATUS wow64_wine_server_call( void *args );
 extern NTSTATUS wow64_wine_server_fd_to_handle( void *args );
 extern NTSTATUS wow64_wine_server_handle_to_fd( void *args );
 extern NTSTATUS wow64_wine_spawnvp( void *args );
+extern NTSTATUS wow64_prefetch_dll( void *args );
 #endif
 
 extern void dbg_init(void);
+extern void dbg_thread_exit(void);
 
 extern void close_inproc_sync( HANDLE handle );
 
@@ -3024,11 +3024,12 @@ static IMAGE_BASE_RELOCATION *process_relocation_block( char *page, IMAGE_BASE_R
  *           map_image_into_view
  *
  * Map an executable (PE format) image into an existing view.
+ * If reloc_fd is valid, the image is mapped from it since it's already relocated.
  * virtual_mutex must be held by caller.
  */
 static NTSTATUS map_image_into_view( struct file_view *view, const UNICODE_STRING *nt_name, int fd,
                                      struct pe_image_info *image_info, USHORT machine,
-                                     int shared_fd, BOOL removable )
+                                     int shared_fd, BOOL removable, int reloc_fd )
 {
     IMAGE_DOS_HEADER *dos;
     IMAGE_NT_HEADERS *nt;
@@ -3100,6 +3101,15 @@ static NTSTATUS map_image_into_view( struct file_view *view, const UNICODE_STRIN
     }
 
 
+    /* map the image already relocated by the server */
+
+    if (reloc_fd != -1)
+    {
+        TRACE_(module)( "mapping relocated %s from cache\n", debugstr_us(nt_name) );
+        if (map_file_into_view( view, reloc_fd, 0, total_size, 0, VPROT_COMMITTED | VPROT_READ | VPROT_WRITECOPY,
+                                FALSE ) != STATUS_SUCCESS) goto done;
+    }
+
     /* map all the sections */
 
     for (i = pos = 0; i < nt->FileHeader.NumberOfSections; i++)
@@ -3156,6 +3166,8 @@ static NTSTATUS map_image_into_view( struct file_view *view, const UNICODE_STRIN
             continue;
         }
 
+        if (reloc_fd != -1) continue;
+
         TRACE_(module)( "mapping %s section %.8s at %p off %x size %x virt %x flags %x\n",
                         debugstr_us(nt_name), sec[i].Name, ptr + sec[i].VirtualAddress,
                         sec[i].PointerToRawData, sec[i].SizeOfRawData,
@@ -3213,7 +3225,7 @@ static NTSTATUS map_image_into_view( struct file_view *view, const UNICODE_STRIN
 
     /* relocate to dynamic base */
 
-    if (image_info->map_addr && (delta = image_info->map_addr - image_info->base))
+    if (image_info->map_addr && (delta = image_info->map_addr - image_info->base) && reloc_fd == -1)
     {
         TRACE_(module)( "relocating %s dynamic base %lx -> %lx mapped at %p\n", debugstr_us(nt_name),
                         (ULONG_PTR)image_info->base, (ULONG_PTR)image_info->map_addr, ptr );
@@ -3387,6 +3399,31 @@ static NTSTATUS map_image_view( struct file_view **view_ret, struct pe_image_inf
 }
 
 
+/***********************************************************************
+ *             get_image_reloc_file
+ *
+ * Get the file holding the image relocated to its map address, shared between processes.
+ */
+static int get_image_reloc_file( HANDLE mapping, int *needs_close )
+{
+    HANDLE file = 0;
+    int unix_fd = -1;
+
+    SERVER_START_REQ( get_image_reloc_file )
+    {
+        req->handle = wine_server_obj_handle( mapping );
+        if (!wine_server_call( req )) file = wine_server_ptr_handle( reply->file );
+    }
+    SERVER_END_REQ;
+
+    if (!file) return -1;
+    if (server_get_unix_fd( file, FILE_READ_DATA, &unix_fd, needs_close, NULL, NULL ))
+        unix_fd = -1;
+    NtClose( file );
+    return unix_fd;
+}
+
+
 /***********************************************************************
  *             virtual_map_image
  *
@@ -3399,6 +3436,8 @@ static NTSTATUS virtual_map_image( HANDLE mapping, void **addr_ptr, SIZE_T *size
 {
     int unix_fd = -1, needs_close;
     int shared_fd = -1, shared_needs_close = 0;
+    int reloc_fd = -1, reloc_needs_close = 0;
+    BOOL use_reloc;
     SIZE_T size = pe_mapping->image.map_size;
     struct file_view *view;
     unsigned int status;
@@ -3430,13 +3469,20 @@ static NTSTATUS virtual_map_image( HANDLE mapping, void **addr_ptr, SIZE_T *size
         SERVER_END_REQ;
     }
 
+    if (pe_mapping->image.map_addr && pe_mapping->image.map_addr != pe_mapping->image.base &&
+        !pe_mapping->image.is_hybrid && !(pe_mapping->image.image_flags & IMAGE_FLAGS_ImageMappedFlat))
+        reloc_fd = get_image_reloc_file( mapping, &reloc_needs_close );
+
     server_enter_uninterrupted_section( &virtual_mutex, &sigset );
 
     status = map_image_view( &view, &pe_mapping->image, size, limit_low, limit_high, alloc_type );
     if (status) goto done;
 
-    status = map_image_into_view( view, &pe_mapping->nt_name, unix_fd, &pe_mapping->image,
-                                  machine, shared_fd, needs_close );
+    /* the shared copy is only valid at the address it was relocated to */
+    use_reloc = reloc_fd != -1 && !offset && view->base == wine_server_get_ptr( pe_mapping->image.map_addr );
+
+    status = map_image_into_view( view, &pe_mapping->nt_name, unix_fd, &pe_mapping->image, machine,
+                                  shared_fd, needs_close, use_reloc ? reloc_fd : -1 );
     if (status == STATUS_SUCCESS)
     {
         if (offset)
@@ -3471,6 +3517,7 @@ done:
     server_leave_uninterrupted_section( &virtual_mutex, &sigset );
     if (needs_close) close( unix_fd );
     if (shared_needs_close) close( shared_fd );
+    if (reloc_needs_close) close( reloc_fd );
     return status;
 }
 
@@ -6547,6 +6594,9 @@ NTSTATUS WINAPI NtQuerySection( HANDLE handle, SECTION_INFORMATION_CLASS class,
     case SectionImageInformation:
         if (size < sizeof(SECTION_IMAGE_INFORMATION)) return STATUS_INFO_LENGTH_MISMATCH;
         break;
+    case SectionOriginalBaseInformation:
+        if (size < sizeof(void *)) return STATUS_INFO_LENGTH_MISMATCH;
+        break;
     default:
 	FIXME( "class %u not implemented\n", class );
 	return STATUS_NOT_IMPLEMENTED;
@@ -6568,13 +6618,18 @@ NTSTATUS WINAPI NtQuerySection( HANDLE handle, SECTION_INFORMATION_CLASS class,
                 info->Size.QuadPart = reply->size;
                 if (ret_size) *ret_size = sizeof(*info);
             }
-            else if (reply->flags & SEC_IMAGE)
+            else if (!(reply->flags & SEC_IMAGE)) status = STATUS_SECTION_NOT_IMAGE;
+            else if (class == SectionOriginalBaseInformation)
+            {
+                *(void **)ptr = wine_server_get_ptr( image_info.base );
+                if (ret_size) *ret_size = sizeof(void *);
+            }
+            else
             {
                 SECTION_IMAGE_INFORMATION *info = ptr;
                 virtual_fill_image_information( &image_info, info );
                 if (ret_size) *ret_size = sizeof(*info);
             }
-            else status = STATUS_SECTION_NOT_IMAGE;
         }
     }
     SERVER_END_REQ;
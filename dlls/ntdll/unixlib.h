@@ -66,6 +66,12 @@ struct unwind_builtin_dll_params
     CONTEXT                    *context;
 };
 
+struct prefetch_dll_params
+{
+    const WCHAR                *nt_name;
+    USHORT                      machine;
+};
+
 enum ntdll_unix_funcs
 {
     unix_load_so_dll,
@@ -76,6 +82,7 @@ enum ntdll_unix_funcs
     unix_wine_server_handle_to_fd,
     unix_wine_spawnvp,
     unix_system_time_precise,
+    unix_prefetch_dll,
 };
 
 extern unixlib_handle_t __wine_unixlib_handle;
@@ -69,6 +69,33 @@ struct register_dll_info
     HMODULE            *modules;
 };
 
+/* a RegisterDlls entry queued for registration on a worker thread */
+struct register_dll_entry
+{
+    WCHAR *path;
+    WCHAR *args;
+    INT    flags;
+    INT    timeout;
+};
+
+/* the entries of a RegisterDlls section registered in parallel */
+struct register_dll_batch
+{
+    struct register_dll_info  *info;
+    struct register_dll_entry *entries;
+    LONG                       count;
+    LONG                       next;
+};
+
+static CRITICAL_SECTION register_dll_cs;
+static CRITICAL_SECTION_DEBUG register_dll_cs_debug =
+{
+    0, 0, &register_dll_cs,
+    { &register_dll_cs_debug.ProcessLocksList, &register_dll_cs_debug.ProcessLocksList },
+    0, 0, { (DWORD_PTR)(__FILE__ ": register_dll_cs") }
+};
+static CRITICAL_SECTION register_dll_cs = { &register_dll_cs_debug, -1, 0, 0, 0, 0 };
+
 /* info passed to callback functions dealing with installing a section */
 struct install_section_callback_info
 {
@@ -558,6 +585,7 @@ static BOOL do_register_dll( struct register_dll_info *info, const WCHAR *path,
     HRESULT res;
     SP_REGISTER_CONTROL_STATUSW status;
     IMAGE_NT_HEADERS *nt;
+    DWORD start = GetTickCount();
 
     status.cbSize = sizeof(status);
     status.FileName = path;
@@ -675,8 +703,13 @@ static BOOL do_register_dll( struct register_dll_info *info, const WCHAR *path,
     }
 
 done:
+    TRACE( "%s %s took %lu ms\n", info->unregister ? "unregistering" : "registering",
+           debugstr_w(path), GetTickCount() - start );
     if (module)
     {
+        BOOL added = FALSE;
+
+        EnterCriticalSection( &register_dll_cs );
         if (info->modules_count >= info->modules_size)
         {
             int new_size = max( 32, info->modules_size * 2 );
@@ -687,8 +720,13 @@ done:
                 info->modules = new;
             }
         }
-        if (info->modules_count < info->modules_size) info->modules[info->modules_count++] = module;
-        else FreeLibrary( module );
+        if (info->modules_count < info->modules_size)
+        {
+            info->modules[info->modules_count++] = module;
+            added = TRUE;
+        }
+        LeaveCriticalSection( &register_dll_cs );
+        if (!added) FreeLibrary( module );
     }
     if (info->callback) info->callback( info->callback_context, SPFILENOTIFY_ENDREGISTRATION,
                                         (UINT_PTR)&status, !info->unregister );
@@ -696,17 +734,86 @@ done:
 }
 
 
+/***********************************************************************
+ *            get_register_threads
+ *
+ * Number of threads used to register the dlls of a RegisterDlls section,
+ * configured with the WINEREGISTERTHREADS environment variable.
+ */
+static int get_register_threads(void)
+{
+    static int threads = -1;
+    const WCHAR *env;
+
+    if (threads == -1)
+    {
+        int count = (env = _wgetenv( L"WINEREGISTERTHREADS" )) ? wcstol( env, NULL, 10 ) : 0;
+        threads = min( max( count, 1 ), MAXIMUM_WAIT_OBJECTS );
+    }
+    return threads;
+}
+
+
+/***********************************************************************
+ *            register_dll_thread
+ *
+ * Worker thread registering the entries of a batch.
+ */
+static DWORD WINAPI register_dll_thread( void *arg )
+{
+    struct register_dll_batch *batch = arg;
+    HRESULT hr = CoInitialize( NULL );
+    LONG i;
+
+    while ((i = InterlockedIncrement( &batch->next ) - 1) < batch->count)
+    {
+        struct register_dll_entry *entry = &batch->entries[i];
+        do_register_dll( batch->info, entry->path, entry->flags, entry->timeout, entry->args );
+    }
+
+    if (SUCCEEDED(hr)) CoUninitialize();
+    return 0;
+}
+
+
+/***********************************************************************
+ *            register_dll_batch
+ *
+ * Register the entries of a batch on worker threads and wait for all of them.
+ */
+static void register_dll_batch( struct register_dll_batch *batch, int threads )
+{
+    HANDLE handles[MAXIMUM_WAIT_OBJECTS];
+    int i, count = 0;
+
+    threads = min( threads, batch->count );
+    for (i = 0; i < threads; i++)
+        if ((handles[count] = CreateThread( NULL, 0, register_dll_thread, batch, 0, NULL ))) count++;
+
+    /* register the remaining entries here if threads could not be created */
+    if (!count) register_dll_thread( batch );
+    WaitForMultipleObjects( count, handles, TRUE, INFINITE );
+    for (i = 0; i < count; i++) CloseHandle( handles[i] );
+}
+
+
 /***********************************************************************
  *            register_dlls_callback
  *
  * Called once for each RegisterDlls entry in a given section.
+ * The entries of a section are independent of each other and may be registered
+ * in parallel; separate sections are registered in order.
  */
 static BOOL register_dlls_callback( HINF hinf, PCWSTR field, void *arg )
 {
     struct register_dll_info *info = arg;
+    struct register_dll_batch batch = { .info = info };
     INFCONTEXT context;
     BOOL ret = TRUE;
     BOOL ok = SetupFindFirstLineW( hinf, field, NULL, &context );
+    int i, threads = info->callback ? 1 : get_register_threads();
+    LONG size = 0;
+    DWORD start = GetTickCount();
 
     for (; ok; ok = SetupFindNextLine( &context, &context ))
     {
@@ -738,12 +845,57 @@ static BOOL register_dlls_callback( HINF hinf, PCWSTR field, void *arg )
         if (SetupGetStringFieldW( &context, 6, buffer, ARRAY_SIZE( buffer ), NULL ))
             args = buffer;
 
+        if (threads > 1)
+        {
+            if (batch.count == size)
+            {
+                LONG new_size = max( 16, size * 2 );
+                struct register_dll_entry *new = realloc( batch.entries, new_size * sizeof(*new) );
+
+                if (new)
+                {
+                    batch.entries = new;
+                    size = new_size;
+                }
+            }
+            if (batch.count < size)
+            {
+                struct register_dll_entry *entry = &batch.entries[batch.count];
+
+                entry->args = args ? wcsdup( args ) : NULL;
+                if (!args || entry->args)
+                {
+                    entry->path = path;
+                    entry->flags = flags;
+                    entry->timeout = timeout;
+                    batch.count++;
+                    continue;
+                }
+            }
+            /* the entry could not be queued, register it right away instead */
+            WARN( "out of memory, registering %s synchronously\n", debugstr_w(path) );
+        }
+
         ret = do_register_dll( info, path, flags, timeout, args );
 
     done:
         free( path );
         if (!ret) break;
     }
+
+    if (batch.count)
+    {
+        register_dll_batch( &batch, threads );
+        for (i = 0; i < batch.count; i++)
+        {
+            free( batch.entries[i].path );
+            free( batch.entries[i].args );
+        }
+    }
+    free( batch.entries );
+
+    TRACE( "%s section %s took %lu ms using %d threads\n", info->unregister ? "unregistering" : "registering",
+           debugstr_w(field), GetTickCount() - start, threads );
     return ret;
 }
 
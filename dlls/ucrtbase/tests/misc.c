@@ -114,6 +114,10 @@ _ACRTIMP void *__cdecl _o_malloc(size_t);
 _se_translator_function __cdecl _set_se_translator(_se_translator_function func);
 void** __cdecl __current_exception(void);
 int* __cdecl __processing_throw(void);
+#ifdef __x86_64__
+int __cdecl _get_FMA3_enable(void);
+int __cdecl _set_FMA3_enable(int);
+#endif
 
 #define _MAX__TIME64_T     (((__time64_t)0x00000007 << 32) | 0x93406FFF)
 
@@ -2110,6 +2114,87 @@ static void test_cargf(void)
     __setusermatherr(NULL);
 }
 
+static void test_log_pow(void)
+{
+    /* inputs close to 1, to the table boundaries and to the ends of the range */
+    static const struct {
+        double x, log, log2;
+    } log_tests[] = {
+        { 1.0000000000000002,   2.2204460492503128e-16,  3.203426503814917e-16  },
+        { 0.9999999999999999,  -1.1102230246251565e-16, -1.6017132519074588e-16 },
+        { 1.0000000002328306,   2.3283064362676457e-10,  3.3590361492731876e-10 },
+        { 0.9375,              -0.06453852113757118,    -0.09310940439148147    },
+        { 1.03515625,           0.034552381506659735,    0.049848549450561525   },
+        { 0.9426947304499507,  -0.059012770444016045,   -0.08513743126870074    },
+        { 0.49999999994179234, -0.6931471806763606,     -1.0000000001679519     },
+        { 1.4142135623730951,   0.3465735902799727,      0.5000000000000001     },
+        { 2.718281828459045,    1.0,                     1.4426950408889634     },
+        { 3.0,                  1.0986122886681098,      1.584962500721156      },
+        { 5e-324,              -744.4400719213812,      -1074.0                 },
+        { 1e-300,              -690.7755278982137,      -996.5784284662087      },
+        { 1.7976931348623157e+308, 709.782712893384,     1024.0                 },
+    };
+    static const struct {
+        double x, y, pow;
+    } pow_tests[] = {
+        { 1.0000000000000002,  4503599627370496.0,  2.718281828459045      },
+        { 0.9999999999999999, -9007199254740992.0,  2.7182818284590455     },
+        { 1.0000001,           1000000000.0,        2.6881038582144647e+43 },
+        { 0.5,                 1074.0,              5e-324                 },
+        { 10.0,                308.0,               1e+308                 },
+        { 2.718281828459045,   709.78,              1.7928227943944479e+308 },
+        { 2.0,                 0.5,                 1.4142135623730951     },
+        { 3.0,                 0.3333333333333333,  1.4422495703074083     },
+        { 7.0,                 0.14285714285714285, 1.3204692477561237     },
+        { 1e-10,               30.5,                1.0000000000000011e-305 },
+        { 1.5,                -1000.5,              6.6175207962444435e-177 },
+        { 0.9,                 6000.0,              2.8513900904532174e-275 },
+    };
+    double r;
+    int i, fma;
+#ifdef __x86_64__
+    int fma_enabled = _get_FMA3_enable();
+#endif
+
+    for (fma = 0; fma < 2; fma++)
+    {
+#ifdef __x86_64__
+        if (fma && !_set_FMA3_enable(1))
+        {
+            skip("FMA3 not supported\n");
+            break;
+        }
+        if (!fma) ok(!_set_FMA3_enable(0), "FMA3 still enabled\n");
+#else
+        if (fma) break;
+#endif
+        winetest_push_context("fma %d", fma);
+
+        for (i = 0; i < ARRAY_SIZE(log_tests); i++)
+        {
+            r = log(log_tests[i].x);
+            ok(compare_double(r, log_tests[i].log, 0), "log(%0.16e) = %0.16e, expected %0.16e\n",
+               log_tests[i].x, r, log_tests[i].log);
+            r = log2(log_tests[i].x);
+            ok(compare_double(r, log_tests[i].log2, 0), "log2(%0.16e) = %0.16e, expected %0.16e\n",
+               log_tests[i].x, r, log_tests[i].log2);
+        }
+
+        for (i = 0; i < ARRAY_SIZE(pow_tests); i++)
+        {
+            r = pow(pow_tests[i].x, pow_tests[i].y);
+            ok(compare_double(r, pow_tests[i].pow, 0), "pow(%0.16e, %0.16e) = %0.16e, expected %0.16e\n",
+               pow_tests[i].x, pow_tests[i].y, r, pow_tests[i].pow);
+        }
+
+        winetest_pop_context();
+    }
+
+#ifdef __x86_64__
+    _set_FMA3_enable(fma_enabled);
+#endif
+}
+
 START_TEST(misc)
 {
     int arg_c;
@@ -2162,4 +2247,5 @@ START_TEST(misc)
     test_cexp();
     test_carg();
     test_cargf();
+    test_log_pow();
 }
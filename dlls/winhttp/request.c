@@ -63,10 +63,35 @@ static BOOL end_of_data_stream( struct request *request )
     return !request->read.size && request->data_stream->vtbl->end_of_data( request->data_stream, request );
 }
 
+/* receive straight into the caller's buffer, bypassing the read buffer */
+static DWORD read_netconn_direct( struct request *request, char *buf, DWORD to_read, DWORD *read )
+{
+    DWORD ret = ERROR_SUCCESS;
+    int received = 0;
+
+    if (!request->data_stream->vtbl->end_of_data( request->data_stream, request ))
+    {
+        to_read = min( to_read, request->content_length - request->content_read );
+        if (!(ret = netconn_recv( request->netconn, buf, to_read, 0, &received )))
+        {
+            if (!received) request->content_length = request->content_read;
+            request->content_read += received;
+        }
+    }
+
+    *read = received;
+    return ret;
+}
+
 static DWORD read_data_stream( struct request *request, char *buf, DWORD to_read, DWORD *read )
 {
     DWORD ret = ERROR_SUCCESS, size = 0;
 
+    /* large reads of an identity-encoded body don't benefit from buffering */
+    if (!request->read.size && to_read >= sizeof(request->read.buf) &&
+        request->data_stream == &request->netconn_stream.data_stream)
+        return read_netconn_direct( request, buf, to_read, read );
+
     if (request->read.size < to_read)
         ret = request->data_stream->vtbl->fill_buffer( request->data_stream, request, &request->read );
     if (ret) return ret;
@@ -1959,13 +1984,13 @@ static void CALLBACK connection_collector( TP_CALLBACK_INSTANCE *instance, void
     FreeLibraryWhenCallbackReturns( instance, winhttp_instance );
 }
 
-static void cache_connection( struct netconn *netconn )
+static void cache_connection( struct netconn *netconn, DWORD timeout )
 {
-    TRACE( "caching connection %p\n", netconn );
+    TRACE( "caching connection %p for %lu ms\n", netconn, timeout );
 
     EnterCriticalSection( &connection_pool_cs );
 
-    netconn->keep_until = GetTickCount64() + DEFAULT_KEEP_ALIVE_TIMEOUT;
+    netconn->keep_until = GetTickCount64() + timeout;
     list_add_head( &netconn->host->connections, &netconn->entry );
 
     if (!connection_collector_running)
@@ -2236,6 +2261,25 @@ static void clear_response_headers( struct request *request )
     }
 }
 
+/* honour a shorter idle timeout advertised with "Keep-Alive: timeout=n" */
+static DWORD get_keep_alive_timeout( struct request *request )
+{
+    WCHAR value[64], *p;
+    DWORD size = sizeof(value), timeout;
+
+    if (query_headers( request, WINHTTP_QUERY_CUSTOM, L"Keep-Alive", value, &size, NULL ))
+        return DEFAULT_KEEP_ALIVE_TIMEOUT;
+
+    for (p = value; *p; p++)
+    {
+        if (wcsnicmp( p, L"timeout=", 8 )) continue;
+        timeout = wcstoul( p + 8, NULL, 10 );
+        if (timeout && timeout < DEFAULT_KEEP_ALIVE_TIMEOUT / 1000) return timeout * 1000;
+        break;
+    }
+    return DEFAULT_KEEP_ALIVE_TIMEOUT;
+}
+
 static void finished_reading( struct request *request )
 {
     BOOL close = FALSE, close_request_headers;
@@ -2265,7 +2309,7 @@ static void finished_reading( struct request *request )
         if (close_request_headers) send_callback( &request->hdr, WINHTTP_CALLBACK_STATUS_CONNECTION_CLOSED, 0, 0 );
     }
     else
-        cache_connection( request->netconn );
+        cache_connection( request->netconn, get_keep_alive_timeout( request ) );
     request->netconn = NULL;
 }
 
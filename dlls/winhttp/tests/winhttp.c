@@ -4106,6 +4106,48 @@ static void test_multiple_reads(int port)
     WinHttpCloseHandle(ses);
 }
 
+static void test_large_reads(int port)
+{
+    HINTERNET ses, con, req;
+    DWORD total_len = 0, bytes_read, i;
+    char *buf;
+    BOOL ret;
+
+    ses = WinHttpOpen(L"winetest", WINHTTP_ACCESS_TYPE_NO_PROXY, NULL, NULL, 0);
+    ok(ses != NULL, "failed to open session %lu\n", GetLastError());
+
+    con = WinHttpConnect(ses, L"localhost", port, 0);
+    ok(con != NULL, "failed to open a connection %lu\n", GetLastError());
+
+    req = WinHttpOpenRequest(con, NULL, L"big", NULL, NULL, NULL, 0);
+    ok(req != NULL, "failed to open a request %lu\n", GetLastError());
+
+    ret = WinHttpSendRequest(req, NULL, 0, NULL, 0, 0, 0);
+    ok(ret, "failed to send request %lu\n", GetLastError());
+
+    ret = WinHttpReceiveResponse(req, NULL);
+    ok(ret == TRUE, "expected success\n");
+
+    /* buffers larger than the internal read buffer */
+    buf = HeapAlloc(GetProcessHeap(), 0, BIG_BUFFER_LEN * 2);
+    for (;;)
+    {
+        bytes_read = 0xdeadbeef;
+        ret = WinHttpReadData(req, buf, BIG_BUFFER_LEN * 2, &bytes_read);
+        ok(ret, "WinHttpReadData failed: %lu\n", GetLastError());
+        if (!ret || !bytes_read) break;
+        for (i = 0; i < bytes_read; i++) if (buf[i] != 'm') break;
+        ok(i == bytes_read, "got wrong data at offset %lu\n", total_len + i);
+        total_len += bytes_read;
+    }
+    ok(total_len == BIG_BUFFER_LEN, "got wrong length: %lu\n", total_len);
+    HeapFree(GetProcessHeap(), 0, buf);
+
+    WinHttpCloseHandle(req);
+    WinHttpCloseHandle(con);
+    WinHttpCloseHandle(ses);
+}
+
 static void test_cookies( int port )
 {
     HINTERNET ses, con, req;
@@ -6437,6 +6479,7 @@ START_TEST (winhttp)
     test_large_data_authentication(si.port);
     test_bad_header(si.port);
     test_multiple_reads(si.port);
+    test_large_reads(si.port);
     test_cookies(si.port);
     test_request_path_escapes(si.port);
     test_passport_auth(si.port);
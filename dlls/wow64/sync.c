@@ -1151,6 +1151,19 @@ NTSTATUS WINAPI wow64_NtQuerySection( UINT *args )
         }
         break;
     }
+    case SectionOriginalBaseInformation:
+    {
+        void *base;
+        ULONG *base32 = ptr;
+
+        if (size < sizeof(*base32)) return STATUS_INFO_LENGTH_MISMATCH;
+        if (!(status = NtQuerySection( handle, class, &base, sizeof(base), &ret_size )))
+        {
+            *base32 = PtrToUlong( base );
+            ret_size = sizeof(*base32);
+        }
+        break;
+    }
     default:
 	FIXME( "class %u not implemented\n", class );
 	return STATUS_NOT_IMPLEMENTED;
@@ -23,6 +23,7 @@
  */
 
 #include "ws2_32_private.h"
+#include "wine/list.h"
 
 WINE_DEFAULT_DEBUG_CHANNEL(winsock);
 WINE_DECLARE_DEBUG_CHANNEL(winediag);
@@ -45,25 +46,184 @@ static char *get_fqdn(void)
     return ret;
 }
 
+/* Results of host name lookups are cached for a short while, so that
+ * applications resolving the same names over and over don't go through the
+ * system resolver each time. The Unix getaddrinfo() doesn't tell us the
+ * record TTL, so use fixed lifetimes, shorter ones for failed lookups. */
+#define ADDRINFO_CACHE_SIZE         64
+#define ADDRINFO_CACHE_TTL          30000  /* ms */
+#define ADDRINFO_CACHE_NEGATIVE_TTL 5000   /* ms */
+
+struct addrinfo_cache_entry
+{
+    struct list      entry;
+    char            *node;
+    char            *service;
+    int              flags;
+    int              family;
+    int              socktype;
+    int              protocol;
+    BOOL             has_hints;
+    ULONGLONG        expires;
+    int              ret;
+    struct addrinfo *info;      /* single block as returned by the Unix side */
+    unsigned int     size;
+};
+
+static struct list addrinfo_cache = LIST_INIT( addrinfo_cache );
+static unsigned int addrinfo_cache_count;
+DECLARE_CRITICAL_SECTION( addrinfo_cache_cs );
+
+static BOOL addrinfo_cache_match( const struct addrinfo_cache_entry *entry, const char *node,
+                                  const char *service, const struct addrinfo *hints )
+{
+    if (strcmp( entry->node, node )) return FALSE;
+    if (!entry->service != !service || (service && strcmp( entry->service, service ))) return FALSE;
+    if (entry->has_hints != !!hints) return FALSE;
+    return !hints || (entry->flags == hints->ai_flags && entry->family == hints->ai_family
+                      && entry->socktype == hints->ai_socktype && entry->protocol == hints->ai_protocol);
+}
+
+static void addrinfo_cache_free( struct addrinfo_cache_entry *entry )
+{
+    list_remove( &entry->entry );
+    addrinfo_cache_count--;
+    free( entry->node );
+    free( entry->service );
+    free( entry->info );
+    free( entry );
+}
+
+/* copy an addrinfo block, fixing up its internal pointers */
+static struct addrinfo *addrinfo_copy_block( const struct addrinfo *info, unsigned int size )
+{
+    struct addrinfo *ret, *ai;
+    INT_PTR delta;
+
+    if (!(ret = malloc( size ))) return NULL;
+    memcpy( ret, info, size );
+    delta = (char *)ret - (const char *)info;
+    for (ai = ret; ai; ai = ai->ai_next)
+    {
+        if (ai->ai_canonname) ai->ai_canonname += delta;
+        if (ai->ai_addr) ai->ai_addr = (struct sockaddr *)((char *)ai->ai_addr + delta);
+        if (ai->ai_next) ai->ai_next = (struct addrinfo *)((char *)ai->ai_next + delta);
+    }
+    return ret;
+}
+
+static BOOL addrinfo_cache_lookup( const char *node, const char *service, const struct addrinfo *hints,
+                                   struct addrinfo **info, int *ret )
+{
+    struct addrinfo_cache_entry *entry, *next;
+    ULONGLONG now = GetTickCount64();
+    BOOL found = FALSE;
+
+    EnterCriticalSection( &addrinfo_cache_cs );
+    LIST_FOR_EACH_ENTRY_SAFE( entry, next, &addrinfo_cache, struct addrinfo_cache_entry, entry )
+    {
+        if (!addrinfo_cache_match( entry, node, service, hints )) continue;
+        if (entry->expires <= now)
+        {
+            addrinfo_cache_free( entry );
+            break;
+        }
+        if (!(*ret = entry->ret) && !(*info = addrinfo_copy_block( entry->info, entry->size )))
+            break;
+        /* keep recently used entries at the head */
+        list_remove( &entry->entry );
+        list_add_head( &addrinfo_cache, &entry->entry );
+        found = TRUE;
+        break;
+    }
+    LeaveCriticalSection( &addrinfo_cache_cs );
+
+    if (found) TRACE( "using cached result for %s, ret %d\n", debugstr_a(node), *ret );
+    return found;
+}
+
+static void addrinfo_cache_add( const char *node, const char *service, const struct addrinfo *hints,
+                                const struct addrinfo *info, unsigned int size, int ret )
+{
+    struct addrinfo_cache_entry *entry, *old;
+
+    if (!(entry = calloc( 1, sizeof(*entry) ))) return;
+    entry->node = strdup( node );
+    entry->service = service ? strdup( service ) : NULL;
+    if (info) entry->info = addrinfo_copy_block( info, size );
+    if (!entry->node || (service && !entry->service) || (info && !entry->info))
+    {
+        free( entry->node );
+        free( entry->service );
+        free( entry->info );
+        free( entry );
+        return;
+    }
+    if ((entry->has_hints = !!hints))
+    {
+        entry->flags    = hints->ai_flags;
+        entry->family   = hints->ai_family;
+        entry->socktype = hints->ai_socktype;
+        entry->protocol = hints->ai_protocol;
+    }
+    entry->size = size;
+    entry->ret = ret;
+    entry->expires = GetTickCount64() + (ret ? ADDRINFO_CACHE_NEGATIVE_TTL : ADDRINFO_CACHE_TTL);
+
+    EnterCriticalSection( &addrinfo_cache_cs );
+    LIST_FOR_EACH_ENTRY( old, &addrinfo_cache, struct addrinfo_cache_entry, entry )
+    {
+        if (!addrinfo_cache_match( old, node, service, hints )) continue;
+        addrinfo_cache_free( old );
+        break;
+    }
+    if (addrinfo_cache_count == ADDRINFO_CACHE_SIZE)
+        addrinfo_cache_free( LIST_ENTRY( list_tail( &addrinfo_cache ), struct addrinfo_cache_entry, entry ) );
+    list_add_head( &addrinfo_cache, &entry->entry );
+    addrinfo_cache_count++;
+    LeaveCriticalSection( &addrinfo_cache_cs );
+}
+
+/* check whether a node name is an IPv4 or IPv6 address literal, which doesn't need the cache */
+static BOOL is_numeric_node( const char *node )
+{
+    const char *terminator;
+    IN6_ADDR addr6;
+    IN_ADDR addr;
+
+    if (!RtlIpv4StringToAddressA( node, TRUE, &terminator, &addr ) && !*terminator) return TRUE;
+    if (!RtlIpv6StringToAddressA( node, &terminator, &addr6 ) && (!*terminator || *terminator == '%')) return TRUE;
+    return FALSE;
+}
+
 /* call Unix getaddrinfo, allocating a large enough buffer */
 static int do_getaddrinfo( const char *node, const char *service,
                            const struct addrinfo *hints, struct addrinfo **info )
 {
     unsigned int size = 1024;
     struct getaddrinfo_params params = { node, service, hints, NULL, &size };
+    BOOL cache = node && (!hints || !(hints->ai_flags & AI_NUMERICHOST)) && !is_numeric_node( node );
     int ret;
 
+    if (cache && addrinfo_cache_lookup( node, service, hints, info, &ret )) return ret;
+
     for (;;)
     {
         if (!(params.info = malloc( size )))
             return WSA_NOT_ENOUGH_MEMORY;
         if (!(ret = WS_CALL( getaddrinfo, &params )))
         {
+            if (cache) addrinfo_cache_add( node, service, hints, params.info, size, 0 );
             *info = params.info;
             return ret;
         }
         free( params.info );
-        if (ret != ERROR_INSUFFICIENT_BUFFER) return ret;
+        if (ret != ERROR_INSUFFICIENT_BUFFER)
+        {
+            /* only remember definite answers, not transient failures */
+            if (cache && ret == EAI_NONAME) addrinfo_cache_add( node, service, hints, NULL, 0, ret );
+            return ret;
+        }
     }
 }
 
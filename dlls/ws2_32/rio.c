@@ -0,0 +1,744 @@
+/*
+ * Registered I/O (RIO) extension functions
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#include "ws2_32_private.h"
+#include "wine/list.h"
+
+WINE_DEFAULT_DEBUG_CHANNEL(winsock);
+
+/* Requests are issued as regular overlapped socket operations. Each request
+ * has its own event, waited on by the thread pool, and the low bit of the
+ * event handle keeps the completion from being queued to any completion port
+ * the application associated with the socket. The wait callback moves the
+ * result into the user-space completion queue, so RIODequeueCompletion never
+ * enters the kernel. */
+
+struct rio_buffer
+{
+    char *data;  /* NULL if the entry is free */
+    DWORD len;
+};
+
+struct rio_cq
+{
+    CRITICAL_SECTION cs;
+    LONG refcount;    /* held by the handle and by each request queue */
+    RIORESULT *results;
+    DWORD size;       /* ring size */
+    DWORD head;       /* index of the oldest result */
+    DWORD count;      /* number of queued results */
+    DWORD reserved;   /* slots reserved by request queues */
+    BOOL corrupt;
+    BOOL notify;      /* notification was requested at creation */
+    BOOL armed;       /* RIONotify has been called */
+    RIO_NOTIFICATION_COMPLETION completion;
+};
+
+struct rio_request
+{
+    OVERLAPPED ovl;
+    struct list entry;
+    struct rio_rq *rq;
+    HANDLE event;
+    PTP_WAIT wait;
+    BOOL send;
+    DWORD flags;
+    ULONGLONG context;
+    WSABUF buf;
+    SOCKADDR_INET addr;
+    int addr_len;
+    char *addr_buf;  /* where to store the source address on completion */
+};
+
+struct rio_rq
+{
+    struct list entry;
+    CRITICAL_SECTION cs;
+    LONG refcount;
+    SOCKET socket;
+    struct rio_cq *recv_cq;
+    struct rio_cq *send_cq;
+    ULONG max_recv, max_send;
+    ULONG recv_count, send_count;
+    ULONGLONG context;
+    struct list free_requests;
+};
+
+static struct list rio_queues = LIST_INIT( rio_queues );
+DECLARE_CRITICAL_SECTION( rio_cs );
+
+/* registered buffers, a buffer id is the index in the table plus one */
+static struct rio_buffer *rio_buffers;
+static unsigned int rio_buffers_size;  /* allocated entries */
+static unsigned int rio_buffers_used;  /* entries up to the last one in use */
+static SRWLOCK rio_buffers_lock = SRWLOCK_INIT;
+
+/* must be called with rio_buffers_lock held */
+static struct rio_buffer *rio_buffer_from_id( RIO_BUFFERID id )
+{
+    ULONG_PTR index = (ULONG_PTR)id - 1;
+
+    if (index >= rio_buffers_used || !rio_buffers[index].data) return NULL;
+    return &rio_buffers[index];
+}
+
+static char *rio_buf_data( const RIO_BUF *buf, ULONG min_len )
+{
+    struct rio_buffer *buffer;
+    char *ret = NULL;
+
+    AcquireSRWLockShared( &rio_buffers_lock );
+    if ((buffer = rio_buffer_from_id( buf->BufferId )) && buf->Offset <= buffer->len
+        && buffer->len - buf->Offset >= buf->Length && buf->Length >= min_len)
+        ret = buffer->data + buf->Offset;
+    ReleaseSRWLockShared( &rio_buffers_lock );
+    return ret;
+}
+
+static void rio_cq_signal( struct rio_cq *cq )
+{
+    cq->armed = FALSE;
+    if (cq->completion.Type == RIO_EVENT_COMPLETION)
+        SetEvent( cq->completion.Event.EventHandle );
+    else
+        PostQueuedCompletionStatus( cq->completion.Iocp.IocpHandle, 0,
+                                    (ULONG_PTR)cq->completion.Iocp.CompletionKey,
+                                    cq->completion.Iocp.Overlapped );
+}
+
+static void rio_cq_push( struct rio_cq *cq, const RIORESULT *result, BOOL notify )
+{
+    EnterCriticalSection( &cq->cs );
+    if (cq->count == cq->size)
+    {
+        ERR( "completion queue %p overflow\n", cq );
+        cq->corrupt = TRUE;
+    }
+    else
+    {
+        cq->results[(cq->head + cq->count) % cq->size] = *result;
+        cq->count++;
+    }
+    if (notify && cq->armed) rio_cq_signal( cq );
+    LeaveCriticalSection( &cq->cs );
+}
+
+static struct rio_cq *rio_cq_grab( struct rio_cq *cq )
+{
+    InterlockedIncrement( &cq->refcount );
+    return cq;
+}
+
+static void rio_cq_release( struct rio_cq *cq )
+{
+    if (InterlockedDecrement( &cq->refcount )) return;
+
+    TRACE( "freeing completion queue %p\n", cq );
+
+    cq->cs.DebugInfo->Spare[0] = 0;
+    DeleteCriticalSection( &cq->cs );
+    free( cq->results );
+    free( cq );
+}
+
+static void rio_rq_release( struct rio_rq *rq )
+{
+    if (InterlockedDecrement( &rq->refcount )) return;
+
+    TRACE( "freeing request queue %p\n", rq );
+
+    EnterCriticalSection( &rq->recv_cq->cs );
+    rq->recv_cq->reserved -= rq->max_recv;
+    LeaveCriticalSection( &rq->recv_cq->cs );
+    EnterCriticalSection( &rq->send_cq->cs );
+    rq->send_cq->reserved -= rq->max_send;
+    LeaveCriticalSection( &rq->send_cq->cs );
+    rio_cq_release( rq->recv_cq );
+    rio_cq_release( rq->send_cq );
+
+    while (!list_empty( &rq->free_requests ))
+    {
+        struct rio_request *request = LIST_ENTRY( list_head( &rq->free_requests ), struct rio_request, entry );
+        list_remove( &request->entry );
+        CloseThreadpoolWait( request->wait );
+        CloseHandle( request->event );
+        free( request );
+    }
+    rq->cs.DebugInfo->Spare[0] = 0;
+    DeleteCriticalSection( &rq->cs );
+    free( rq );
+}
+
+static void CALLBACK rio_wait_callback( TP_CALLBACK_INSTANCE *instance, void *context, TP_WAIT *wait,
+                                        TP_WAIT_RESULT result )
+{
+    struct rio_request *request = context;
+    struct rio_rq *rq = request->rq;
+    RIORESULT res;
+    BOOL notify = !(request->flags & RIO_MSG_DONT_NOTIFY);
+    struct rio_cq *cq;
+
+    res.Status = 0;
+    res.SocketContext = rq->context;
+    res.RequestContext = request->context;
+    /* the socket may already be closed, so don't go through WSAGetOverlappedResult() */
+    if (NT_SUCCESS( request->ovl.Internal ))
+        res.BytesTransferred = request->ovl.InternalHigh;
+    else
+    {
+        res.Status = NtStatusToWSAError( request->ovl.Internal );
+        res.BytesTransferred = 0;
+    }
+    if (!res.Status && request->addr_buf)
+        memcpy( request->addr_buf, &request->addr, sizeof(request->addr) );
+
+    TRACE( "rq %p, request %p, status %ld, size %lu\n", rq, request, res.Status, res.BytesTransferred );
+
+    EnterCriticalSection( &rq->cs );
+    if (request->send)
+    {
+        rq->send_count--;
+        cq = rq->send_cq;
+    }
+    else
+    {
+        rq->recv_count--;
+        cq = rq->recv_cq;
+    }
+    list_add_head( &rq->free_requests, &request->entry );
+    LeaveCriticalSection( &rq->cs );
+
+    rio_cq_push( cq, &res, notify );
+    rio_rq_release( rq );
+}
+
+static BOOL rio_submit( struct rio_rq *rq, BOOL send, const RIO_BUF *data, ULONG count,
+                        const RIO_BUF *local, const RIO_BUF *remote, DWORD flags, void *context )
+{
+    struct rio_request *request;
+    char *remote_data = NULL;
+    char *ptr;
+    int ret;
+
+    TRACE( "rq %p, send %d, data %p, count %lu, flags %#lx, context %p\n",
+           rq, send, data, count, flags, context );
+
+    if (!rq)
+    {
+        SetLastError( WSAEINVAL );
+        return FALSE;
+    }
+    if (flags & ~(RIO_MSG_DONT_NOTIFY | RIO_MSG_DEFER | RIO_MSG_WAITALL | RIO_MSG_COMMIT_ONLY))
+    {
+        SetLastError( WSAEINVAL );
+        return FALSE;
+    }
+    /* requests are always issued immediately, so there is nothing to commit */
+    if (flags & RIO_MSG_COMMIT_ONLY)
+    {
+        if (count || data)
+        {
+            SetLastError( WSAEINVAL );
+            return FALSE;
+        }
+        return TRUE;
+    }
+    if (count != 1 || !data || !(ptr = rio_buf_data( data, 0 )))
+    {
+        SetLastError( WSAEINVAL );
+        return FALSE;
+    }
+    if (send && (flags & RIO_MSG_WAITALL))
+    {
+        SetLastError( WSAEINVAL );
+        return FALSE;
+    }
+    if (local) FIXME( "local address not supported\n" );
+    if (remote && !(remote_data = rio_buf_data( remote, sizeof(SOCKADDR_INET) )))
+    {
+        SetLastError( WSAEINVAL );
+        return FALSE;
+    }
+
+    EnterCriticalSection( &rq->cs );
+    if (send ? rq->send_count >= rq->max_send : rq->recv_count >= rq->max_recv)
+    {
+        LeaveCriticalSection( &rq->cs );
+        SetLastError( WSAENOBUFS );
+        return FALSE;
+    }
+    if (!list_empty( &rq->free_requests ))
+    {
+        request = LIST_ENTRY( list_head( &rq->free_requests ), struct rio_request, entry );
+        list_remove( &request->entry );
+    }
+    else if (!(request = malloc( sizeof(*request) )) || !(request->event = CreateEventW( NULL, FALSE, FALSE, NULL )))
+    {
+        LeaveCriticalSection( &rq->cs );
+        free( request );
+        SetLastError( WSAENOBUFS );
+        return FALSE;
+    }
+    else if (!(request->wait = CreateThreadpoolWait( rio_wait_callback, request, NULL )))
+    {
+        LeaveCriticalSection( &rq->cs );
+        CloseHandle( request->event );
+        free( request );
+        SetLastError( WSAENOBUFS );
+        return FALSE;
+    }
+    if (send) rq->send_count++;
+    else rq->recv_count++;
+    LeaveCriticalSection( &rq->cs );
+
+    memset( &request->ovl, 0, sizeof(request->ovl) );
+    request->ovl.hEvent = (HANDLE)((ULONG_PTR)request->event | 1);
+    request->rq = rq;
+    request->send = send;
+    request->flags = flags;
+    request->context = (ULONG_PTR)context;
+    request->buf.buf = ptr;
+    request->buf.len = data->Length;
+    request->addr_len = sizeof(request->addr);
+    request->addr_buf = NULL;
+
+    InterlockedIncrement( &rq->refcount );
+    SetThreadpoolWait( request->wait, request->event, NULL );
+
+    if (send)
+    {
+        if (remote_data)
+        {
+            memcpy( &request->addr, remote_data, sizeof(request->addr) );
+            ret = WSASendTo( rq->socket, &request->buf, 1, NULL, 0, (struct sockaddr *)&request->addr,
+                             request->addr_len, &request->ovl, NULL );
+        }
+        else
+            ret = WSASend( rq->socket, &request->buf, 1, NULL, 0, &request->ovl, NULL );
+    }
+    else
+    {
+        DWORD recv_flags = (flags & RIO_MSG_WAITALL) ? MSG_WAITALL : 0;
+
+        if (remote_data)
+        {
+            request->addr_buf = remote_data;
+            ret = WSARecvFrom( rq->socket, &request->buf, 1, NULL, &recv_flags, (struct sockaddr *)&request->addr,
+                               &request->addr_len, &request->ovl, NULL );
+        }
+        else
+            ret = WSARecv( rq->socket, &request->buf, 1, NULL, &recv_flags, &request->ovl, NULL );
+    }
+
+    if (ret && WSAGetLastError() != WSA_IO_PENDING)
+    {
+        DWORD err = WSAGetLastError();
+
+        SetThreadpoolWait( request->wait, NULL, NULL );
+        WaitForThreadpoolWaitCallbacks( request->wait, TRUE );
+        EnterCriticalSection( &rq->cs );
+        if (send) rq->send_count--;
+        else rq->recv_count--;
+        list_add_head( &rq->free_requests, &request->entry );
+        LeaveCriticalSection( &rq->cs );
+        rio_rq_release( rq );
+        SetLastError( err );
+        return FALSE;
+    }
+    return TRUE;
+}
+
+
+static BOOL WINAPI WS2_RIOReceive( RIO_RQ rq, PRIO_BUF data, ULONG count, DWORD flags, void *context )
+{
+    return rio_submit( (struct rio_rq *)rq, FALSE, data, count, NULL, NULL, flags, context );
+}
+
+
+static int WINAPI WS2_RIOReceiveEx( RIO_RQ rq, PRIO_BUF data, ULONG count, PRIO_BUF local, PRIO_BUF remote,
+                                    PRIO_BUF control, PRIO_BUF flags_buf, DWORD flags, void *context )
+{
+    if (control || flags_buf) FIXME( "control %p, flags %p not supported\n", control, flags_buf );
+    return rio_submit( (struct rio_rq *)rq, FALSE, data, count, local, remote, flags, context );
+}
+
+
+static BOOL WINAPI WS2_RIOSend( RIO_RQ rq, PRIO_BUF data, ULONG count, DWORD flags, void *context )
+{
+    return rio_submit( (struct rio_rq *)rq, TRUE, data, count, NULL, NULL, flags, context );
+}
+
+
+static BOOL WINAPI WS2_RIOSendEx( RIO_RQ rq, PRIO_BUF data, ULONG count, PRIO_BUF local, PRIO_BUF remote,
+                                  PRIO_BUF control, PRIO_BUF flags_buf, DWORD flags, void *context )
+{
+    if (control || flags_buf) FIXME( "control %p, flags %p not supported\n", control, flags_buf );
+    return rio_submit( (struct rio_rq *)rq, TRUE, data, count, local, remote, flags, context );
+}
+
+
+static void WINAPI WS2_RIOCloseCompletionQueue( RIO_CQ handle )
+{
+    struct rio_cq *cq = (struct rio_cq *)handle;
+
+    TRACE( "%p\n", cq );
+
+    if (!cq) return;
+    /* request queues still using it keep it alive until they are freed */
+    rio_cq_release( cq );
+}
+
+
+static RIO_CQ WINAPI WS2_RIOCreateCompletionQueue( DWORD size, PRIO_NOTIFICATION_COMPLETION completion )
+{
+    struct rio_cq *cq;
+
+    TRACE( "size %lu, completion %p\n", size, completion );
+
+    if (!size || size > RIO_MAX_CQ_SIZE)
+    {
+        SetLastError( WSAEINVAL );
+        return RIO_INVALID_CQ;
+    }
+    if (completion)
+    {
+        if ((completion->Type == RIO_EVENT_COMPLETION && !completion->Event.EventHandle)
+            || (completion->Type == RIO_IOCP_COMPLETION && !completion->Iocp.IocpHandle)
+            || (completion->Type != RIO_EVENT_COMPLETION && completion->Type != RIO_IOCP_COMPLETION))
+        {
+            SetLastError( WSAEINVAL );
+            return RIO_INVALID_CQ;
+        }
+    }
+
+    if (!(cq = calloc( 1, sizeof(*cq) )) || !(cq->results = malloc( size * sizeof(*cq->results) )))
+    {
+        free( cq );
+        SetLastError( WSAENOBUFS );
+        return RIO_INVALID_CQ;
+    }
+    InitializeCriticalSection( &cq->cs );
+    cq->cs.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": rio_cq.cs");
+    cq->refcount = 1;
+    cq->size = size;
+    if (completion)
+    {
+        cq->notify = TRUE;
+        cq->completion = *completion;
+    }
+    return (RIO_CQ)cq;
+}
+
+
+static RIO_RQ WINAPI WS2_RIOCreateRequestQueue( SOCKET s, ULONG max_recv, ULONG max_recv_buffers,
+                                                ULONG max_send, ULONG max_send_buffers,
+                                                RIO_CQ recv_handle, RIO_CQ send_handle, void *context )
+{
+    struct rio_cq *recv_cq = (struct rio_cq *)recv_handle, *send_cq = (struct rio_cq *)send_handle;
+    struct rio_rq *rq, *other;
+    int type, len = sizeof(type);
+    BOOL ok;
+
+    TRACE( "socket %#Ix, recv %lu/%lu, send %lu/%lu, cq %p/%p, context %p\n", s, max_recv,
+           max_recv_buffers, max_send, max_send_buffers, recv_cq, send_cq, context );
+
+    if (!recv_cq || !send_cq || max_recv_buffers != 1 || max_send_buffers != 1)
+    {
+        SetLastError( WSAEINVAL );
+        return RIO_INVALID_RQ;
+    }
+
+    if (getsockopt( s, SOL_SOCKET, SO_TYPE, (char *)&type, &len )) return RIO_INVALID_RQ;
+
+    if (!(rq = calloc( 1, sizeof(*rq) )))
+    {
+        SetLastError( WSAENOBUFS );
+        return RIO_INVALID_RQ;
+    }
+    InitializeCriticalSection( &rq->cs );
+    rq->cs.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": rio_rq.cs");
+    rq->refcount = 1;
+    rq->socket = s;
+    rq->max_recv = max_recv;
+    rq->max_send = max_send;
+    rq->context = (ULONG_PTR)context;
+    list_init( &rq->free_requests );
+
+    /* make sure every outstanding request has room in its completion queue */
+    EnterCriticalSection( &recv_cq->cs );
+    if ((ok = recv_cq->size - recv_cq->reserved >= max_recv)) recv_cq->reserved += max_recv;
+    LeaveCriticalSection( &recv_cq->cs );
+    if (ok)
+    {
+        EnterCriticalSection( &send_cq->cs );
+        if ((ok = send_cq->size - send_cq->reserved >= max_send)) send_cq->reserved += max_send;
+        LeaveCriticalSection( &send_cq->cs );
+        if (!ok)
+        {
+            EnterCriticalSection( &recv_cq->cs );
+            recv_cq->reserved -= max_recv;
+            LeaveCriticalSection( &recv_cq->cs );
+        }
+    }
+    if (!ok)
+    {
+        rq->cs.DebugInfo->Spare[0] = 0;
+        DeleteCriticalSection( &rq->cs );
+        free( rq );
+        SetLastError( WSAENOBUFS );
+        return RIO_INVALID_RQ;
+    }
+    rq->recv_cq = rio_cq_grab( recv_cq );
+    rq->send_cq = rio_cq_grab( send_cq );
+
+    EnterCriticalSection( &rio_cs );
+    LIST_FOR_EACH_ENTRY( other, &rio_queues, struct rio_rq, entry )
+    {
+        if (other->socket != s) continue;
+        LeaveCriticalSection( &rio_cs );
+        rio_rq_release( rq );
+        SetLastError( WSAEINVAL );
+        return RIO_INVALID_RQ;
+    }
+    list_add_tail( &rio_queues, &rq->entry );
+    LeaveCriticalSection( &rio_cs );
+
+    return (RIO_RQ)rq;
+}
+
+
+static ULONG WINAPI WS2_RIODequeueCompletion( RIO_CQ handle, PRIORESULT results, ULONG size )
+{
+    struct rio_cq *cq = (struct rio_cq *)handle;
+    ULONG count = 0;
+
+    TRACE( "cq %p, results %p, size %lu\n", cq, results, size );
+
+    if (!cq || !results) return RIO_CORRUPT_CQ;
+
+    EnterCriticalSection( &cq->cs );
+    if (cq->corrupt)
+    {
+        LeaveCriticalSection( &cq->cs );
+        return RIO_CORRUPT_CQ;
+    }
+    while (count < size && cq->count)
+    {
+        results[count++] = cq->results[cq->head];
+        cq->head = (cq->head + 1) % cq->size;
+        cq->count--;
+    }
+    LeaveCriticalSection( &cq->cs );
+    return count;
+}
+
+
+static void WINAPI WS2_RIODeregisterBuffer( RIO_BUFFERID id )
+{
+    struct rio_buffer *buffer;
+
+    TRACE( "%p\n", id );
+
+    AcquireSRWLockExclusive( &rio_buffers_lock );
+    if ((buffer = rio_buffer_from_id( id )))
+    {
+        buffer->data = NULL;
+        while (rio_buffers_used && !rio_buffers[rio_buffers_used - 1].data) rio_buffers_used--;
+    }
+    ReleaseSRWLockExclusive( &rio_buffers_lock );
+    if (!buffer) SetLastError( WSAEINVAL );
+}
+
+
+static int WINAPI WS2_RIONotify( RIO_CQ handle )
+{
+    struct rio_cq *cq = (struct rio_cq *)handle;
+    int ret = 0;
+
+    TRACE( "%p\n", cq );
+
+    if (!cq || !cq->notify) return WSAEINVAL;
+
+    EnterCriticalSection( &cq->cs );
+    if (cq->armed)
+        ret = WSAEALREADY;
+    else
+    {
+        if (cq->completion.Type == RIO_EVENT_COMPLETION && cq->completion.Event.NotifyReset)
+            ResetEvent( cq->completion.Event.EventHandle );
+        cq->armed = TRUE;
+        if (cq->count) rio_cq_signal( cq );
+    }
+    LeaveCriticalSection( &cq->cs );
+    return ret;
+}
+
+
+static RIO_BUFFERID WINAPI WS2_RIORegisterBuffer( PCHAR data, DWORD len )
+{
+    struct rio_buffer *buffers;
+    unsigned int i, size;
+
+    TRACE( "data %p, len %lu\n", data, len );
+
+    if (!data || !len)
+    {
+        SetLastError( WSAEINVAL );
+        return RIO_INVALID_BUFFERID;
+    }
+
+    AcquireSRWLockExclusive( &rio_buffers_lock );
+    for (i = 0; i < rio_buffers_used; i++) if (!rio_buffers[i].data) break;
+    if (i == rio_buffers_size)
+    {
+        size = max( rio_buffers_size * 2, 16 );
+        if (!(buffers = realloc( rio_buffers, size * sizeof(*buffers) )))
+        {
+            ReleaseSRWLockExclusive( &rio_buffers_lock );
+            SetLastError( WSAENOBUFS );
+            return RIO_INVALID_BUFFERID;
+        }
+        rio_buffers = buffers;
+        rio_buffers_size = size;
+    }
+    if (i == rio_buffers_used) rio_buffers_used++;
+    rio_buffers[i].data = data;
+    rio_buffers[i].len = len;
+    ReleaseSRWLockExclusive( &rio_buffers_lock );
+    return (RIO_BUFFERID)(ULONG_PTR)(i + 1);
+}
+
+
+static BOOL WINAPI WS2_RIOResizeCompletionQueue( RIO_CQ handle, DWORD size )
+{
+    struct rio_cq *cq = (struct rio_cq *)handle;
+    RIORESULT *results;
+    DWORD i;
+
+    TRACE( "cq %p, size %lu\n", cq, size );
+
+    if (!cq || !size || size > RIO_MAX_CQ_SIZE)
+    {
+        SetLastError( WSAEINVAL );
+        return FALSE;
+    }
+
+    EnterCriticalSection( &cq->cs );
+    if (size < cq->count || size < cq->reserved)
+    {
+        LeaveCriticalSection( &cq->cs );
+        SetLastError( WSAEINVAL );
+        return FALSE;
+    }
+    if (!(results = malloc( size * sizeof(*results) )))
+    {
+        LeaveCriticalSection( &cq->cs );
+        SetLastError( WSAENOBUFS );
+        return FALSE;
+    }
+    for (i = 0; i < cq->count; i++) results[i] = cq->results[(cq->head + i) % cq->size];
+    free( cq->results );
+    cq->results = results;
+    cq->size = size;
+    cq->head = 0;
+    LeaveCriticalSection( &cq->cs );
+    return TRUE;
+}
+
+
+static BOOL rio_cq_reserve( struct rio_cq *cq, ULONG old, ULONG new )
+{
+    BOOL ret;
+
+    EnterCriticalSection( &cq->cs );
+    if ((ret = new <= old || cq->size - cq->reserved >= new - old))
+        cq->reserved = cq->reserved - old + new;
+    LeaveCriticalSection( &cq->cs );
+    return ret;
+}
+
+static BOOL WINAPI WS2_RIOResizeRequestQueue( RIO_RQ handle, DWORD max_recv, DWORD max_send )
+{
+    struct rio_rq *rq = (struct rio_rq *)handle;
+    BOOL ret = FALSE;
+
+    TRACE( "rq %p, recv %lu, send %lu\n", rq, max_recv, max_send );
+
+    if (!rq)
+    {
+        SetLastError( WSAEINVAL );
+        return FALSE;
+    }
+
+    EnterCriticalSection( &rq->cs );
+    if (max_recv < rq->recv_count || max_send < rq->send_count)
+        SetLastError( WSAEINVAL );
+    else if (!rio_cq_reserve( rq->recv_cq, rq->max_recv, max_recv ))
+        SetLastError( WSAENOBUFS );
+    else if (!rio_cq_reserve( rq->send_cq, rq->max_send, max_send ))
+    {
+        rio_cq_reserve( rq->recv_cq, max_recv, rq->max_recv );
+        SetLastError( WSAENOBUFS );
+    }
+    else
+    {
+        rq->max_recv = max_recv;
+        rq->max_send = max_send;
+        ret = TRUE;
+    }
+    LeaveCriticalSection( &rq->cs );
+    return ret;
+}
+
+
+const RIO_EXTENSION_FUNCTION_TABLE rio_function_table =
+{
+    sizeof(RIO_EXTENSION_FUNCTION_TABLE),
+    WS2_RIOReceive,
+    WS2_RIOReceiveEx,
+    WS2_RIOSend,
+    WS2_RIOSendEx,
+    WS2_RIOCloseCompletionQueue,
+    WS2_RIOCreateCompletionQueue,
+    WS2_RIOCreateRequestQueue,
+    WS2_RIODequeueCompletion,
+    WS2_RIODeregisterBuffer,
+    WS2_RIONotify,
+    WS2_RIORegisterBuffer,
+    WS2_RIOResizeCompletionQueue,
+    WS2_RIOResizeRequestQueue,
+};
+
+
+/* called from closesocket(); drops the reference held on behalf of the socket */
+void rio_socket_closed( SOCKET s )
+{
+    struct rio_rq *rq, *found = NULL;
+
+    EnterCriticalSection( &rio_cs );
+    LIST_FOR_EACH_ENTRY( rq, &rio_queues, struct rio_rq, entry )
+    {
+        if (rq->socket != s) continue;
+        list_remove( &rq->entry );
+        found = rq;
+        break;
+    }
+    LeaveCriticalSection( &rio_cs );
+
+    if (found) rio_rq_release( found );
+}
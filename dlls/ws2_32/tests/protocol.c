@@ -2299,6 +2299,24 @@ static void test_getaddrinfo(void)
     ok(!ret, "getaddrinfo failed with %d\n", WSAGetLastError());
     freeaddrinfo(result);
 
+    /* repeated lookups return independent copies of the same result */
+    hint.ai_family = AF_INET;
+    hint.ai_socktype = SOCK_STREAM;
+    result = NULL;
+    ret = getaddrinfo("localhost", "80", &hint, &result);
+    ok(!ret, "getaddrinfo failed with %d\n", WSAGetLastError());
+    result2 = NULL;
+    ret = getaddrinfo("localhost", "80", &hint, &result2);
+    ok(!ret, "getaddrinfo failed with %d\n", WSAGetLastError());
+    ok(result != result2, "got the same pointer\n");
+    compare_addrinfo(result, result2);
+    freeaddrinfo(result);
+    sockaddr = (SOCKADDR_IN *)result2->ai_addr;
+    ok(sockaddr->sin_family == AF_INET, "got family %u\n", sockaddr->sin_family);
+    ok(sockaddr->sin_port == htons(80), "got port %u\n", ntohs(sockaddr->sin_port));
+    freeaddrinfo(result2);
+    memset(&hint, 0, sizeof(ADDRINFOA));
+
     result = NULL;
     ret = getaddrinfo("localhost", "80", NULL, &result);
     ok(!ret, "getaddrinfo failed with %d\n", WSAGetLastError());
@@ -14333,6 +14333,177 @@ static void test_connect_udp(void)
     closesocket(client);
 }
 
+static void test_registered_io(void)
+{
+    const struct sockaddr_in bind_addr = {.sin_family = AF_INET, .sin_addr.s_addr = htonl(INADDR_LOOPBACK)};
+    GUID rio_guid = WSAID_MULTIPLE_RIO;
+    RIO_EXTENSION_FUNCTION_TABLE rio;
+    RIO_NOTIFICATION_COMPLETION notify;
+    RIO_BUF buf, send_buf, addr_buf;
+    RIO_CQ send_cq, recv_cq;
+    RIO_BUFFERID buffer_id;
+    struct sockaddr_in addr;
+    SOCKADDR_INET *remote;
+    RIO_RQ server_rq, client_rq;
+    char buffer[256 + sizeof(SOCKADDR_INET)];
+    SOCKET client, server;
+    RIORESULT results[4];
+    OVERLAPPED *ovl;
+    ULONG_PTR key;
+    DWORD size;
+    HANDLE event, port;
+    ULONG count;
+    int ret, len, i;
+
+    server = WSASocketW(AF_INET, SOCK_DGRAM, IPPROTO_UDP, NULL, 0, WSA_FLAG_OVERLAPPED | WSA_FLAG_REGISTERED_IO);
+    ok(server != INVALID_SOCKET, "got error %u\n", WSAGetLastError());
+    client = WSASocketW(AF_INET, SOCK_DGRAM, IPPROTO_UDP, NULL, 0, WSA_FLAG_OVERLAPPED | WSA_FLAG_REGISTERED_IO);
+    ok(client != INVALID_SOCKET, "got error %u\n", WSAGetLastError());
+
+    memset(&rio, 0, sizeof(rio));
+    size = 0xdeadbeef;
+    ret = WSAIoctl(server, SIO_GET_MULTIPLE_EXTENSION_FUNCTION_POINTER, &rio_guid, sizeof(rio_guid),
+                   &rio, sizeof(rio), &size, NULL, NULL);
+    if (ret)
+    {
+        win_skip("Registered I/O is not supported.\n");
+        closesocket(client);
+        closesocket(server);
+        return;
+    }
+    ok(size == sizeof(rio), "got size %lu\n", size);
+    ok(rio.cbSize == sizeof(rio), "got cbSize %lu\n", rio.cbSize);
+
+    ret = bind(server, (const struct sockaddr *)&bind_addr, sizeof(bind_addr));
+    ok(!ret, "got error %u\n", WSAGetLastError());
+    len = sizeof(addr);
+    ret = getsockname(server, (struct sockaddr *)&addr, &len);
+    ok(!ret, "got error %u\n", WSAGetLastError());
+    ret = connect(client, (struct sockaddr *)&addr, sizeof(addr));
+    ok(!ret, "got error %u\n", WSAGetLastError());
+
+    buffer_id = rio.RIORegisterBuffer(buffer, sizeof(buffer));
+    ok(buffer_id != RIO_INVALID_BUFFERID, "got error %u\n", WSAGetLastError());
+
+    event = CreateEventW(NULL, FALSE, FALSE, NULL);
+    notify.Type = RIO_EVENT_COMPLETION;
+    notify.Event.EventHandle = event;
+    notify.Event.NotifyReset = FALSE;
+    recv_cq = rio.RIOCreateCompletionQueue(2, &notify);
+    ok(recv_cq != RIO_INVALID_CQ, "got error %u\n", WSAGetLastError());
+    send_cq = rio.RIOCreateCompletionQueue(4, NULL);
+    ok(send_cq != RIO_INVALID_CQ, "got error %u\n", WSAGetLastError());
+
+    /* the completion queue must be large enough for all outstanding requests */
+    WSASetLastError(0xdeadbeef);
+    server_rq = rio.RIOCreateRequestQueue(server, 4, 1, 1, 1, recv_cq, send_cq, (void *)0x1234);
+    ok(server_rq == RIO_INVALID_RQ, "expected failure\n");
+    ok(WSAGetLastError() == WSAENOBUFS, "got error %u\n", WSAGetLastError());
+
+    server_rq = rio.RIOCreateRequestQueue(server, 2, 1, 1, 1, recv_cq, send_cq, (void *)0x1234);
+    ok(server_rq != RIO_INVALID_RQ, "got error %u\n", WSAGetLastError());
+    /* the socket can still be associated with a completion port of its own */
+    port = CreateIoCompletionPort((HANDLE)client, NULL, 0, 0);
+    ok(port != NULL, "got error %lu\n", GetLastError());
+    client_rq = rio.RIOCreateRequestQueue(client, 0, 1, 2, 1, recv_cq, send_cq, (void *)0x5678);
+    ok(client_rq != RIO_INVALID_RQ, "got error %u\n", WSAGetLastError());
+
+    ret = rio.RIONotify(recv_cq);
+    ok(!ret, "got %d\n", ret);
+    ret = rio.RIONotify(recv_cq);
+    ok(ret == WSAEALREADY, "got %d\n", ret);
+
+    count = rio.RIODequeueCompletion(recv_cq, results, ARRAY_SIZE(results));
+    ok(!count, "got %lu\n", count);
+
+    buf.BufferId = buffer_id;
+    buf.Offset = 0;
+    buf.Length = 128;
+    addr_buf.BufferId = buffer_id;
+    addr_buf.Offset = 256;
+    addr_buf.Length = sizeof(SOCKADDR_INET);
+    ret = rio.RIOReceiveEx(server_rq, &buf, 1, NULL, &addr_buf, NULL, NULL, 0, (void *)0x10);
+    ok(ret, "got error %u\n", WSAGetLastError());
+
+    /* the queue was created with room for two outstanding receives */
+    ret = rio.RIOReceive(server_rq, &buf, 1, 0, (void *)0x11);
+    ok(ret, "got error %u\n", WSAGetLastError());
+    WSASetLastError(0xdeadbeef);
+    ret = rio.RIOReceive(server_rq, &buf, 1, 0, (void *)0x12);
+    ok(!ret, "expected failure\n");
+    ok(WSAGetLastError() == WSAENOBUFS, "got error %u\n", WSAGetLastError());
+
+    /* buffers must lie inside the registered region */
+    send_buf.BufferId = buffer_id;
+    send_buf.Offset = sizeof(buffer) - 4;
+    send_buf.Length = 8;
+    WSASetLastError(0xdeadbeef);
+    ret = rio.RIOSend(client_rq, &send_buf, 1, 0, (void *)0x20);
+    ok(!ret, "expected failure\n");
+    ok(WSAGetLastError() == WSAEINVAL, "got error %u\n", WSAGetLastError());
+
+    memcpy(buffer + 128, "data", 4);
+    send_buf.BufferId = (RIO_BUFFERID)0xdeadbeef;
+    send_buf.Offset = 128;
+    send_buf.Length = 4;
+    WSASetLastError(0xdeadbeef);
+    ret = rio.RIOSend(client_rq, &send_buf, 1, 0, (void *)0x20);
+    ok(!ret, "expected failure\n");
+    ok(WSAGetLastError() == WSAEINVAL, "got error %u\n", WSAGetLastError());
+
+    send_buf.BufferId = buffer_id;
+    ret = rio.RIOSend(client_rq, &send_buf, 1, 0, (void *)0x20);
+    ok(ret, "got error %u\n", WSAGetLastError());
+
+    ret = WaitForSingleObject(event, 1000);
+    ok(!ret, "wait returned %d\n", ret);
+
+    for (i = 0; i < 100; ++i)
+    {
+        if ((count = rio.RIODequeueCompletion(send_cq, results, ARRAY_SIZE(results)))) break;
+        Sleep(10);
+    }
+    ok(count == 1, "got %lu send completions\n", count);
+    ok(!results[0].Status, "got status %ld\n", results[0].Status);
+    ok(results[0].BytesTransferred == 4, "got size %lu\n", results[0].BytesTransferred);
+    ok(results[0].SocketContext == 0x5678, "got socket context %#I64x\n", results[0].SocketContext);
+    ok(results[0].RequestContext == 0x20, "got request context %#I64x\n", results[0].RequestContext);
+
+    /* completions only go to the RIO completion queue */
+    ret = GetQueuedCompletionStatus(port, &size, &key, &ovl, 0);
+    ok(!ret, "got a completion packet\n");
+    ok(GetLastError() == WAIT_TIMEOUT, "got error %lu\n", GetLastError());
+
+    count = rio.RIODequeueCompletion(recv_cq, results, ARRAY_SIZE(results));
+    ok(count == 1, "got %lu\n", count);
+    ok(!results[0].Status, "got status %ld\n", results[0].Status);
+    ok(results[0].BytesTransferred == 4, "got size %lu\n", results[0].BytesTransferred);
+    ok(results[0].SocketContext == 0x1234, "got socket context %#I64x\n", results[0].SocketContext);
+    ok(results[0].RequestContext == 0x10, "got request context %#I64x\n", results[0].RequestContext);
+    ok(!memcmp(buffer, "data", 4), "got %s\n", debugstr_an(buffer, 4));
+    remote = (SOCKADDR_INET *)(buffer + 256);
+    ok(remote->si_family == AF_INET, "got family %u\n", remote->si_family);
+    ok(remote->Ipv4.sin_addr.s_addr == htonl(INADDR_LOOPBACK), "got address %#lx\n", remote->Ipv4.sin_addr.s_addr);
+
+    /* closing the socket cancels the outstanding receive */
+    ret = rio.RIONotify(recv_cq);
+    ok(!ret, "got %d\n", ret);
+    closesocket(server);
+    ret = WaitForSingleObject(event, 1000);
+    ok(!ret, "wait returned %d\n", ret);
+    count = rio.RIODequeueCompletion(recv_cq, results, ARRAY_SIZE(results));
+    ok(count == 1, "got %lu\n", count);
+    ok(results[0].Status == WSA_OPERATION_ABORTED, "got status %ld\n", results[0].Status);
+    ok(results[0].RequestContext == 0x11, "got request context %#I64x\n", results[0].RequestContext);
+
+    closesocket(client);
+    rio.RIOCloseCompletionQueue(recv_cq);
+    rio.RIOCloseCompletionQueue(send_cq);
+    rio.RIODeregisterBuffer(buffer_id);
+    CloseHandle(port);
+    CloseHandle(event);
+}
+
 static void test_tcp_sendto_recvfrom(void)
 {
     SOCKET client, server = 0;
@@ -14970,6 +15141,7 @@ START_TEST( sock )
     test_icmp();
     test_icmpv6();
     test_connect_udp();
+    test_registered_io();
     test_tcp_sendto_recvfrom();
     test_broadcast();
     test_send_buffering();
@@ -94,6 +94,11 @@ extern int num_startup;
 
 struct per_thread_data *get_per_thread_data(void);
 
+DWORD NtStatusToWSAError( NTSTATUS status );
+
+extern const RIO_EXTENSION_FUNCTION_TABLE rio_function_table;
+void rio_socket_closed( SOCKET s );
+
 struct getaddrinfo_params
 {
     const char *node;
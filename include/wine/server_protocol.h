@@ -2039,7 +2039,7 @@ struct recv_socket_reply
     obj_handle_t wait;
     unsigned int options;
     int          nonblocking;
-    char __pad_20[4];
+    int          icmp_over_dgram;
 };
 
 
@@ -2056,7 +2056,8 @@ struct send_socket_reply
     obj_handle_t wait;
     unsigned int options;
     int          nonblocking;
-    char __pad_20[4];
+    unsigned short type;
+    unsigned short icmp_over_dgram;
 };
 
 #define SERVER_SOCKET_IO_FORCE_ASYNC 0x01
@@ -2235,6 +2236,20 @@ struct get_image_map_address_reply
 
 
 
+struct get_image_reloc_file_request
+{
+    struct request_header __header;
+    obj_handle_t handle;
+};
+struct get_image_reloc_file_reply
+{
+    struct reply_header __header;
+    obj_handle_t file;
+    char __pad_12[4];
+};
+
+
+
 struct map_view_request
 {
     struct request_header __header;
@@ -2746,6 +2761,20 @@ struct save_registry_reply
 
 
 
+struct restore_registry_request
+{
+    struct request_header __header;
+    obj_handle_t hkey;
+    obj_handle_t file;
+    char __pad_20[4];
+};
+struct restore_registry_reply
+{
+    struct reply_header __header;
+};
+
+
+
 struct set_registry_notification_request
 {
     struct request_header __header;
@@ -5514,6 +5543,15 @@ struct add_completion_reply
 };
 
 
+struct completion_msg
+{
+    apc_param_t   ckey;
+    apc_param_t   cvalue;
+    apc_param_t   information;
+    unsigned int  status;
+    int           __pad;
+};
+
 
 struct remove_completion_request
 {
@@ -5530,6 +5568,7 @@ struct remove_completion_reply
     apc_param_t   information;
     unsigned int  status;
     obj_handle_t  wait_handle;
+    /* VARARG(msgs,completion_msgs); */
 };
 
 
@@ -5546,6 +5585,7 @@ struct get_thread_completion_reply
     apc_param_t   cvalue;
     apc_param_t   information;
     unsigned int  status;
+    /* VARARG(msgs,completion_msgs); */
     char __pad_36[4];
 };
 
@@ -6231,6 +6271,7 @@ enum request
     REQ_open_mapping,
     REQ_get_mapping_info,
     REQ_get_image_map_address,
+    REQ_get_image_reloc_file,
     REQ_map_view,
     REQ_map_image_view,
     REQ_map_builtin_view,
@@ -6262,6 +6303,7 @@ enum request
     REQ_load_registry,
     REQ_unload_registry,
     REQ_save_registry,
+    REQ_restore_registry,
     REQ_set_registry_notification,
     REQ_rename_key,
     REQ_create_timer,
@@ -6544,6 +6586,7 @@ union generic_request
     struct open_mapping_request open_mapping_request;
     struct get_mapping_info_request get_mapping_info_request;
     struct get_image_map_address_request get_image_map_address_request;
+    struct get_image_reloc_file_request get_image_reloc_file_request;
     struct map_view_request map_view_request;
     struct map_image_view_request map_image_view_request;
     struct map_builtin_view_request map_builtin_view_request;
@@ -6575,6 +6618,7 @@ union generic_request
     struct load_registry_request load_registry_request;
     struct unload_registry_request unload_registry_request;
     struct save_registry_request save_registry_request;
+    struct restore_registry_request restore_registry_request;
     struct set_registry_notification_request set_registry_notification_request;
     struct rename_key_request rename_key_request;
     struct create_timer_request create_timer_request;
@@ -6855,6 +6899,7 @@ union generic_reply
     struct open_mapping_reply open_mapping_reply;
     struct get_mapping_info_reply get_mapping_info_reply;
     struct get_image_map_address_reply get_image_map_address_reply;
+    struct get_image_reloc_file_reply get_image_reloc_file_reply;
     struct map_view_reply map_view_reply;
     struct map_image_view_reply map_image_view_reply;
     struct map_builtin_view_reply map_builtin_view_reply;
@@ -6886,6 +6931,7 @@ union generic_reply
     struct load_registry_reply load_registry_reply;
     struct unload_registry_reply unload_registry_reply;
     struct save_registry_reply save_registry_reply;
+    struct restore_registry_reply restore_registry_reply;
     struct set_registry_notification_reply set_registry_notification_reply;
     struct rename_key_reply rename_key_reply;
     struct create_timer_reply create_timer_reply;
@@ -7096,6 +7142,6 @@ union generic_reply
     struct d3dkmt_mutex_release_reply d3dkmt_mutex_release_reply;
 };
 
-#define SERVER_PROTOCOL_VERSION 931
+#define SERVER_PROTOCOL_VERSION 938
 
 #endif /* __WINE_WINE_SERVER_PROTOCOL_H */
@@ -99,6 +99,30 @@ static int32_t converttoint(double_t);
 #define predict_false(x) (x)
 #endif
 
+/* Whether the fma variants are used, see __fma_supported.c.  The crt
+   can turn them off through _set_FMA3_enable().  */
+hidden extern int __fma_enabled;
+hidden int __fma_supported(void);
+hidden int __fma_init(void);
+
+/* On x86_64 the fma variants of the hottest functions are built
+   separately and selected at runtime, when the cpu supports them.  */
+#if defined(__x86_64__) && !defined(__arm64ec__) && !__FP_FAST_FMA
+#define WANT_FMA_DISPATCH 1
+#ifdef __clang__
+#define FMA_TARGET_BEGIN _Pragma("clang attribute push (__attribute__((target(\"fma\"))), apply_to = function)")
+#define FMA_TARGET_END _Pragma("clang attribute pop")
+#else
+#define FMA_TARGET_BEGIN _Pragma("GCC push_options") _Pragma("GCC target(\"fma\")")
+#define FMA_TARGET_END _Pragma("GCC pop_options")
+#endif
+#define fma_enabled() (predict_true(__fma_enabled >= 0) ? __fma_enabled : __fma_init())
+hidden double __log_fma(double);
+hidden double __log2_fma(double);
+#else
+#define WANT_FMA_DISPATCH 0
+#endif
+
 /* Evaluate an expression as the specified type. With standard excess
    precision handling a type cast or assignment is enough (with
    -ffloat-store an assignment is required, in old compilers argument
@@ -0,0 +1,32 @@
+#include "libm.h"
+
+/* -1 until the first call, then whether the fma variants are used */
+int __fma_enabled = -1;
+
+int __fma_supported(void)
+{
+#if defined(__x86_64__) && !defined(__arm64ec__)
+	static int supported = -1;
+	unsigned int eax, ebx, ecx, edx;
+
+	if (predict_true(supported >= 0))
+		return supported;
+
+	__asm__("cpuid" : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx) : "a"(1), "c"(0));
+	/* fma needs both the instructions and the os saving the ymm state */
+	if ((ecx & (1 << 12)) && (ecx & (1 << 27))) {
+		__asm__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+		supported = (eax & 6) == 6;
+	} else {
+		supported = 0;
+	}
+	return supported;
+#else
+	return 0;
+#endif
+}
+
+int __fma_init(void)
+{
+	return __fma_enabled = __fma_supported();
+}
@@ -32,6 +32,11 @@ double __cdecl log(double x)
 	uint32_t top;
 	int k, i;
 
+#if WANT_FMA_DISPATCH
+	if (fma_enabled())
+		return __log_fma(x);
+#endif
+
 	ix = asuint64(x);
 	top = top16(x);
 #define LO asuint64(1.0 - 0x1p-4)
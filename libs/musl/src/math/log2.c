@@ -32,6 +32,11 @@ double __cdecl log2(double x)
 	uint32_t top;
 	int k, i;
 
+#if WANT_FMA_DISPATCH
+	if (fma_enabled())
+		return __log2_fma(x);
+#endif
+
 	ix = asuint64(x);
 	top = top16(x);
 #define LO asuint64(1.0 - 0x1.5b51p-5)
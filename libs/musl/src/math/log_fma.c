@@ -0,0 +1,20 @@
+/*
+ * log() using fma instructions, selected at runtime by log().
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include "libm.h"
+#include "log_data.h"
+
+#if WANT_FMA_DISPATCH
+#undef WANT_FMA_DISPATCH
+#define WANT_FMA_DISPATCH 0
+#undef __FP_FAST_FMA
+#define __FP_FAST_FMA 1
+#define log __log_fma
+
+FMA_TARGET_BEGIN
+#include "log.c"
+FMA_TARGET_END
+#endif
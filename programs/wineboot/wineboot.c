@@ -58,6 +58,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <intrin.h>
+#include <wctype.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
@@ -1633,6 +1634,282 @@ static void update_user_profile(void)
     LocalFree(sid);
 }
 
+/* build a Win32 path from a \??\ prefixed config directory and a sub path */
+static WCHAR *get_config_path( const WCHAR *config_dir, const WCHAR *subdir )
+{
+    WCHAR *path = malloc( (wcslen(config_dir) + wcslen(subdir) + 2) * sizeof(WCHAR) );
+
+    if (!path) return NULL;
+    swprintf( path, wcslen(config_dir) + wcslen(subdir) + 2, L"%s\\%s", config_dir, subdir );
+    path[1] = '\\';  /* change \??\ to \\?\ */
+    return path;
+}
+
+/* return the directory of the prefix template matching the current wine.inf, Wine build, user and
+ * architectures, or NULL if prefix templates are not enabled with WINEPREFIXTEMPLATE */
+static WCHAR *get_template_dir( unsigned long timestamp )
+{
+    const char * (CDECL *wine_get_build_id)(void);
+    const WCHAR *root = _wgetenv( L"WINEPREFIXTEMPLATE" );
+    WCHAR user[256], version[512], *dir, *p;
+    DWORD size = ARRAY_SIZE(user);
+    int i, len;
+
+    if (!root || root[0] != '/') return NULL;
+    wine_get_build_id = (void *)GetProcAddress( GetModuleHandleW( L"ntdll.dll" ), "wine_get_build_id" );
+    if (!wine_get_build_id || !GetUserNameW( user, &size )) return NULL;
+
+    len = swprintf( version, ARRAY_SIZE(version), L"%S-%lx-%s", wine_get_build_id(), timestamp, user );
+    for (i = 0; machines[i].Machine && len > 0; i++)
+        len += swprintf( version + len, ARRAY_SIZE(version) - len, L"-%04x", machines[i].Machine );
+    if (len <= 0) return NULL;
+    for (p = version; *p; p++) if (!iswalnum( *p ) && !wcschr( L".-_", *p )) *p = '_';
+
+    len = wcslen(root) + wcslen(version) + ARRAY_SIZE(L"\\\\?\\unix\\");
+    if (!(dir = malloc( len * sizeof(WCHAR) ))) return NULL;
+    swprintf( dir, len, L"\\\\?\\unix%s/%s", root, version );
+    for (p = dir; *p; p++) if (*p == '/') *p = '\\';
+    return dir;
+}
+
+/* recursively copy a directory, skipping reparse points such as the links to the unix home directory */
+static BOOL copy_tree( const WCHAR *src, const WCHAR *dst )
+{
+    WIN32_FIND_DATAW data;
+    WCHAR *src_path, *dst_path;
+    size_t src_len = wcslen(src) + MAX_PATH + 2, dst_len = wcslen(dst) + MAX_PATH + 2;
+    HANDLE handle;
+    BOOL ret = FALSE;
+
+    if (!CreateDirectoryW( dst, NULL ) && GetLastError() != ERROR_ALREADY_EXISTS) return FALSE;
+
+    src_path = malloc( src_len * sizeof(WCHAR) );
+    dst_path = malloc( dst_len * sizeof(WCHAR) );
+    if (!src_path || !dst_path) goto done;
+
+    swprintf( src_path, src_len, L"%s\\*", src );
+    if ((handle = FindFirstFileW( src_path, &data )) == INVALID_HANDLE_VALUE)
+    {
+        WINE_WARN( "failed to list %s, error %lu\n", debugstr_w(src), GetLastError() );
+        goto done;
+    }
+    ret = TRUE;
+    do
+    {
+        if (!wcscmp( data.cFileName, L"." ) || !wcscmp( data.cFileName, L".." )) continue;
+        if (data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) continue;
+        swprintf( src_path, src_len, L"%s\\%s", src, data.cFileName );
+        swprintf( dst_path, dst_len, L"%s\\%s", dst, data.cFileName );
+        if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) ret = copy_tree( src_path, dst_path );
+        else if (!(ret = CopyFileW( src_path, dst_path, FALSE )))
+            WINE_WARN( "failed to copy %s to %s, error %lu\n",
+                       debugstr_w(src_path), debugstr_w(dst_path), GetLastError() );
+    } while (ret && FindNextFileW( handle, &data ));
+    FindClose( handle );
+
+done:
+    free( src_path );
+    free( dst_path );
+    return ret;
+}
+
+/* recursively delete a directory */
+static void delete_tree( const WCHAR *dir )
+{
+    WIN32_FIND_DATAW data;
+    size_t len = wcslen(dir) + MAX_PATH + 2;
+    WCHAR *path = malloc( len * sizeof(WCHAR) );
+    HANDLE handle;
+
+    if (!path) return;
+    swprintf( path, len, L"%s\\*", dir );
+    if ((handle = FindFirstFileW( path, &data )) != INVALID_HANDLE_VALUE)
+    {
+        do
+        {
+            if (!wcscmp( data.cFileName, L"." ) || !wcscmp( data.cFileName, L".." )) continue;
+            swprintf( path, len, L"%s\\%s", dir, data.cFileName );
+            if ((data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) &&
+                !(data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT))
+                delete_tree( path );
+            else if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+                RemoveDirectoryW( path );
+            else
+                DeleteFileW( path );
+        } while (FindNextFileW( handle, &data ));
+        FindClose( handle );
+    }
+    RemoveDirectoryW( dir );
+    free( path );
+}
+
+static WCHAR *template_dir;  /* prefix template to create after updating the prefix */
+
+static const struct
+{
+    HKEY         root;
+    const WCHAR *subkey;
+    const WCHAR *file;
+} template_hives[] =
+{
+    { HKEY_LOCAL_MACHINE, NULL, L"system.reg" },
+    { HKEY_CURRENT_USER, NULL, L"user.reg" },
+    { HKEY_USERS, L".Default", L"userdef.reg" },
+};
+
+/* save or restore the registry hives of a prefix template */
+static BOOL transfer_template_registry( const WCHAR *dir, BOOL save )
+{
+    WCHAR path[MAX_PATH];
+    BOOLEAN old;
+    DWORD res = 0;
+    HKEY hkey;
+    int i;
+
+    RtlAdjustPrivilege( save ? SE_BACKUP_PRIVILEGE : SE_RESTORE_PRIVILEGE, TRUE, FALSE, &old );
+    for (i = 0; i < ARRAY_SIZE(template_hives) && !res; i++)
+    {
+        swprintf( path, ARRAY_SIZE(path), L"%s\\%s", dir, template_hives[i].file );
+        if ((res = RegOpenKeyExW( template_hives[i].root, template_hives[i].subkey, 0, KEY_ALL_ACCESS, &hkey )))
+            break;
+        if (save) res = RegSaveKeyExW( hkey, path, NULL, 0 );
+        else res = RegRestoreKeyW( hkey, path, 0 );
+        RegCloseKey( hkey );
+    }
+    RtlAdjustPrivilege( save ? SE_BACKUP_PRIVILEGE : SE_RESTORE_PRIVILEGE, old, FALSE, &old );
+    if (res) WINE_WARN( "failed to %s registry in %s, error %lu\n",
+                        save ? "save" : "restore", debugstr_w(dir), res );
+    return !res;
+}
+
+/* delete the driver keys of the devices found under an Enum key */
+static void delete_device_driver_keys( HKEY key )
+{
+    WCHAR name[MAX_PATH], driver[MAX_PATH], path[MAX_PATH];
+    DWORD i, size = sizeof(driver), type;
+    HKEY subkey;
+
+    if (!RegQueryValueExW( key, L"Driver", NULL, &type, (BYTE *)driver, &size ) &&
+        type == REG_SZ && wcschr( driver, '\\' ))
+    {
+        swprintf( path, ARRAY_SIZE(path), L"System\\CurrentControlSet\\Control\\Class\\%s", driver );
+        RegDeleteTreeW( HKEY_LOCAL_MACHINE, path );
+    }
+
+    for (i = 0; !RegEnumKeyW( key, i, name, ARRAY_SIZE(name) ); i++)
+    {
+        if (RegOpenKeyExW( key, name, 0, KEY_READ, &subkey )) continue;
+        delete_device_driver_keys( subkey );
+        RegCloseKey( subkey );
+    }
+}
+
+/* delete the keys that describe the machine the template was created on; the devices are
+ * enumerated again by their drivers, mountmgr recreates the volume mappings, and advapi32
+ * generates a new machine guid when it's needed */
+static void reset_template_machine_keys(void)
+{
+    HKEY key;
+
+    if (!RegOpenKeyExW( HKEY_LOCAL_MACHINE, L"System\\CurrentControlSet\\Enum", 0, KEY_READ, &key ))
+    {
+        delete_device_driver_keys( key );
+        RegCloseKey( key );
+    }
+    RegDeleteTreeW( HKEY_LOCAL_MACHINE, L"System\\CurrentControlSet\\Enum" );
+    RegDeleteTreeW( HKEY_LOCAL_MACHINE, L"System\\CurrentControlSet\\Control\\DeviceClasses" );
+    RegDeleteTreeW( HKEY_LOCAL_MACHINE, L"System\\MountedDevices" );
+    RegDeleteKeyValueW( HKEY_LOCAL_MACHINE, L"Software\\Microsoft\\Cryptography", L"MachineGuid" );
+}
+
+/* initialize a new prefix from the template matching the current configuration; this needs
+ * to be done before services.exe is started so that it finds the services of the template */
+static BOOL restore_prefix_template(void)
+{
+    const WCHAR *config_dir = _wgetenv( L"WINECONFIGDIR" );
+    WCHAR *inf_path = get_wine_inf_path(), *dir = NULL, *src = NULL, *dst = NULL;
+    struct stat st;
+    BOOL ret = FALSE;
+    size_t len;
+    int fd;
+
+    if (!inf_path) return FALSE;
+    fd = _wopen( inf_path, O_RDONLY );
+    free( inf_path );
+    if (fd == -1) return FALSE;
+    fstat( fd, &st );
+    close( fd );
+
+    if (!(dir = get_template_dir( st.st_mtime ))) return FALSE;
+
+    /* only new prefixes are initialized from a template */
+    if (!(dst = get_config_path( config_dir, L".update-timestamp" ))) goto done;
+    if (GetFileAttributesW( dst ) != INVALID_FILE_ATTRIBUTES) goto done;
+    free( dst );
+    dst = NULL;
+
+    if (GetFileAttributesW( dir ) == INVALID_FILE_ATTRIBUTES)
+    {
+        /* create it once the prefix has been installed */
+        template_dir = dir;
+        return FALSE;
+    }
+
+    len = wcslen(dir) + ARRAY_SIZE(L"\\drive_c");
+    if (!(src = malloc( len * sizeof(WCHAR) ))) goto done;
+    swprintf( src, len, L"%s\\drive_c", dir );
+    if (!(dst = get_config_path( config_dir, L"drive_c" ))) goto done;
+
+    if (transfer_template_registry( dir, FALSE ) && copy_tree( src, dst ))
+    {
+        reset_template_machine_keys();
+        update_timestamp( config_dir, st.st_mtime );
+        create_computer_name_keys();
+        WINE_TRACE( "initialized prefix from template %s\n", debugstr_w(dir) );
+        ret = TRUE;
+    }
+
+done:
+    free( src );
+    free( dst );
+    free( dir );
+    return ret;
+}
+
+/* save the freshly installed prefix as a template for the next ones */
+static void save_prefix_template( const WCHAR *config_dir, const WCHAR *dir )
+{
+    size_t len = wcslen(dir) + ARRAY_SIZE(L".12345678\\drive_c");
+    WCHAR *tmp = malloc( len * sizeof(WCHAR) ), *src = get_config_path( config_dir, L"drive_c" ), *dst, *p;
+    BOOL ret = FALSE;
+
+    if (!tmp || !src) goto done;
+
+    /* create the parent directory */
+    lstrcpyW( tmp, dir );
+    if ((p = wcsrchr( tmp, '\\' )))
+    {
+        *p = 0;
+        CreateDirectoryW( tmp, NULL );
+    }
+
+    /* populate a private directory first, so that other processes never see a partial template */
+    swprintf( tmp, len, L"%s.%08lx", dir, GetCurrentProcessId() );
+    if (!CreateDirectoryW( tmp, NULL )) goto done;
+    dst = tmp + wcslen(tmp);
+    lstrcpyW( dst, L"\\drive_c" );
+    ret = copy_tree( src, tmp );
+    *dst = 0;
+    if (ret) ret = transfer_template_registry( tmp, TRUE );
+    if (ret) ret = MoveFileW( tmp, dir );
+    if (!ret) delete_tree( tmp );
+    else WINE_TRACE( "saved prefix template %s\n", debugstr_w(dir) );
+
+done:
+    free( tmp );
+    free( src );
+}
+
 /* execute rundll32 on the wine.inf file if necessary */
 static void update_wineprefix( BOOL force )
 {
@@ -1688,6 +1965,8 @@ static void update_wineprefix( BOOL force )
         install_root_pnp_devices();
         update_user_profile();
 
+        if (template_dir) save_prefix_template( config_dir, template_dir );
+
         TRACE( "wine: configuration in %s has been updated.\n", debugstr_w(prettyprint_configdir()) );
     }
 
@@ -1797,7 +2076,7 @@ int __cdecl main( int argc, char *argv[] )
     OBJECT_ATTRIBUTES attr;
     UNICODE_STRING nameW = RTL_CONSTANT_STRING( L"\\KernelObjects\\__wineboot_event" );
     HANDLE process = 0;
-    BOOL is_wow64;
+    BOOL is_wow64, from_template = FALSE;
 
     end_session = force = init = kill = restart = shutdown = update = FALSE;
     GetWindowsDirectoryW( windowsdir, MAX_PATH );
@@ -1894,11 +2173,15 @@ int __cdecl main( int argc, char *argv[] )
     ProcessWindowsFileProtection();
     ProcessRunKeys( HKEY_LOCAL_MACHINE, L"RunServicesOnce", TRUE, FALSE );
 
+    if (init) from_template = restore_prefix_template();
+
     if (init || (kill && !restart))
     {
         ProcessRunKeys( HKEY_LOCAL_MACHINE, L"RunServices", FALSE, FALSE );
         start_services_process();
     }
+    /* the root devices of the template have been removed, install them again */
+    if (from_template) install_root_pnp_devices();
     if (init || update) update_wineprefix( update );
 
     create_volatile_environment_registry_key();
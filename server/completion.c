@@ -76,6 +76,8 @@ struct completion
     struct list         queue;
     struct list         wait_queue;
     unsigned int        depth;
+    unsigned int        wakeups;      /* number of waits satisfied by a completion */
+    unsigned int        woken_msgs;   /* number of completions returned after those waits */
 };
 
 static void completion_wait_dump( struct object*, int );
@@ -201,7 +203,8 @@ static void completion_dump( struct object *obj, int verbose )
     struct completion *completion = (struct completion *) obj;
 
     assert( obj->ops == &completion_ops );
-    fprintf( stderr, "Completion depth=%u\n", completion->depth );
+    fprintf( stderr, "Completion depth=%u wakeups=%u completions=%u\n",
+             completion->depth, completion->wakeups, completion->woken_msgs );
 }
 
 static struct object *completion_get_sync( struct object *obj )
@@ -277,6 +280,8 @@ static struct completion *create_completion( struct object *root, const struct u
             list_init( &completion->queue );
             list_init( &completion->wait_queue );
             completion->depth = 0;
+            completion->wakeups = 0;
+            completion->woken_msgs = 0;
 
             if (!(completion->sync = create_internal_sync( 1, 0 )))
             {
@@ -318,6 +323,34 @@ void add_completion( struct completion *completion, apc_param_t ckey, apc_param_
     if (!list_empty( &completion->queue )) signal_sync( completion->sync );
 }
 
+/* hand out further queued completions in the same reply, if the client has room for them */
+static data_size_t get_extra_completions( struct completion *completion )
+{
+    struct completion_msg *msgs;
+    struct comp_msg *msg;
+    struct list *entry;
+    data_size_t i, count;
+
+    if (!(count = get_reply_max_size() / sizeof(*msgs)) || list_empty( &completion->queue )) return 0;
+    if (count > completion->depth) count = completion->depth;
+    if (!(msgs = set_reply_data_size( count * sizeof(*msgs) ))) return 0;
+
+    for (i = 0; i < count; i++)
+    {
+        entry = list_head( &completion->queue );
+        list_remove( entry );
+        completion->depth--;
+        msg = LIST_ENTRY( entry, struct comp_msg, queue_entry );
+        msgs[i].ckey        = msg->ckey;
+        msgs[i].cvalue      = msg->cvalue;
+        msgs[i].information = msg->information;
+        msgs[i].status      = msg->status;
+        msgs[i].__pad       = 0;
+        free( msg );
+    }
+    return count;
+}
+
 /* create a completion */
 DECL_HANDLER(create_completion)
 {
@@ -416,6 +449,8 @@ DECL_HANDLER(remove_completion)
         reply->information = msg->information;
         free( msg );
         reply->wait_handle = 0;
+
+        get_extra_completions( completion );
         if (list_empty( &completion->queue )) reset_sync( completion->sync );
     }
 
@@ -425,6 +460,7 @@ DECL_HANDLER(remove_completion)
 /* get completion after successful waiting for it */
 DECL_HANDLER(get_thread_completion)
 {
+    struct completion *completion;
     struct comp_msg *msg;
 
     if (!current->completion_wait || !(msg = current->completion_wait->msg))
@@ -439,7 +475,14 @@ DECL_HANDLER(get_thread_completion)
     reply->information = msg->information;
     free( msg );
     current->completion_wait->msg = NULL;
-    if (!current->completion_wait->completion) cleanup_thread_completion( current );
+    if ((completion = current->completion_wait->completion))
+    {
+        /* return the rest of a burst with this wakeup instead of another wait */
+        completion->wakeups++;
+        completion->woken_msgs += 1 + get_extra_completions( completion );
+        if (list_empty( &completion->queue )) reset_sync( completion->sync );
+    }
+    else cleanup_thread_completion( current );
 }
 
 /* get queue depth for completion port */
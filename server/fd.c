@@ -155,6 +155,8 @@ struct fd
     unsigned int         cacheable :1;/* can the fd be cached on the client side? */
     unsigned int         fs_locks :1; /* can we use filesystem locks for this fd? */
     int                  poll_index;  /* index of fd in poll array */
+    int                  epoll_events;/* events currently registered with epoll */
+    struct list          epoll_entry; /* entry in the list of fds with deferred epoll changes */
     struct async_queue   read_q;      /* async readers of this fd */
     struct async_queue   write_q;     /* async writers of this fd */
     struct async_queue   wait_q;      /* other async waiters of this fd */
@@ -533,52 +535,80 @@ static inline void fd_poll_event( struct fd *fd, int event )
 #ifdef USE_EPOLL
 
 static int epoll_fd = -1;
+static struct list epoll_pending_list = LIST_INIT( epoll_pending_list );  /* fds with deferred changes */
 
 static inline void init_epoll(void)
 {
     epoll_fd = epoll_create( 128 );
 }
 
-/* set the events that epoll waits for on this fd; helper for set_fd_events */
-static inline void set_fd_epoll_events( struct fd *fd, int user, int events )
+static inline void do_epoll_ctl( struct fd *fd, int user, int ctl, int events )
 {
     struct epoll_event ev;
-    int ctl;
 
+    ev.events = events;
+    memset(&ev.data, 0, sizeof(ev.data));
+    ev.data.u32 = user;
+
+    if (epoll_ctl( epoll_fd, ctl, fd->unix_fd, &ev ) == -1)
+    {
+        if (errno == ENOMEM)  /* not enough memory, give up on epoll */
+        {
+            close( epoll_fd );
+            epoll_fd = -1;
+        }
+        else perror( "epoll_ctl" );  /* should not happen */
+    }
+    else fd->epoll_events = events;
+}
+
+/* set the events that epoll waits for on this fd; helper for set_fd_events */
+static inline void set_fd_epoll_events( struct fd *fd, int user, int events )
+{
     if (epoll_fd == -1) return;
 
     if (events == -1)  /* stop waiting on this fd completely */
     {
         if (pollfd[user].fd == -1) return;  /* already removed */
-        ctl = EPOLL_CTL_DEL;
+        list_remove( &fd->epoll_entry );
+        list_init( &fd->epoll_entry );
+        do_epoll_ctl( fd, user, EPOLL_CTL_DEL, 0 );
     }
     else if (pollfd[user].fd == -1)
     {
-        ctl = EPOLL_CTL_ADD;
+        do_epoll_ctl( fd, user, EPOLL_CTL_ADD, events );
     }
-    else
+    else if (list_empty( &fd->epoll_entry ))
     {
-        if (pollfd[user].events == events) return;  /* nothing to do */
-        ctl = EPOLL_CTL_MOD;
+        /* the events of an fd often change back and forth while handling a single
+         * batch of events, so modifications are only applied before the next wait */
+        list_add_tail( &epoll_pending_list, &fd->epoll_entry );
     }
+}
 
-    ev.events = events;
-    memset(&ev.data, 0, sizeof(ev.data));
-    ev.data.u32 = user;
+/* apply the deferred changes of the events epoll waits for */
+static inline void flush_epoll_events(void)
+{
+    struct list *ptr;
 
-    if (epoll_ctl( epoll_fd, ctl, fd->unix_fd, &ev ) == -1)
+    while ((ptr = list_head( &epoll_pending_list )))
     {
-        if (errno == ENOMEM)  /* not enough memory, give up on epoll */
-        {
-            close( epoll_fd );
-            epoll_fd = -1;
-        }
-        else perror( "epoll_ctl" );  /* should not happen */
+        struct fd *fd = LIST_ENTRY( ptr, struct fd, epoll_entry );
+        int user = fd->poll_index;
+
+        list_remove( &fd->epoll_entry );
+        list_init( &fd->epoll_entry );
+        if (epoll_fd == -1 || pollfd[user].fd == -1) continue;
+        if (pollfd[user].events == fd->epoll_events) continue;  /* back to where it was */
+        do_epoll_ctl( fd, user, EPOLL_CTL_MOD, pollfd[user].events );
     }
 }
 
 static inline void remove_epoll_user( struct fd *fd, int user )
 {
+    list_remove( &fd->epoll_entry );
+    list_init( &fd->epoll_entry );
+
     if (epoll_fd == -1) return;
 
     if (pollfd[user].fd != -1)
@@ -609,6 +639,7 @@ static inline void main_loop_epoll(void)
         timeout = get_next_timeout( &ts );
 
         if (!active_users) break;  /* last user removed by a timeout */
+        flush_epoll_events();
         if (epoll_fd == -1) break;  /* an error occurred with epoll */
 
 #ifdef HAVE_EPOLL_PWAIT2
@@ -1736,6 +1767,7 @@ static struct fd *alloc_fd_object(void)
     fd->cacheable  = 0;
     fd->fs_locks   = 1;
     fd->poll_index = -1;
+    fd->epoll_events = 0;
     fd->completion = NULL;
     fd->comp_flags = 0;
     init_async_queue( &fd->read_q );
@@ -1743,6 +1775,7 @@ static struct fd *alloc_fd_object(void)
     init_async_queue( &fd->wait_q );
     list_init( &fd->inode_entry );
     list_init( &fd->locks );
+    list_init( &fd->epoll_entry );
 
     if (!(fd->sync = create_internal_sync( 1, 1 ))) goto error;
     if ((fd->poll_index = add_poll_user( fd )) == -1) goto error;
@@ -1778,6 +1811,7 @@ struct fd *alloc_pseudo_fd( const struct fd_ops *fd_user_ops, struct object *use
     fd->cacheable  = 0;
     fd->fs_locks   = 0;
     fd->poll_index = -1;
+    fd->epoll_events = 0;
     fd->completion = NULL;
     fd->comp_flags = 0;
     fd->no_fd_status = STATUS_BAD_DEVICE_TYPE;
@@ -1786,6 +1820,7 @@ struct fd *alloc_pseudo_fd( const struct fd_ops *fd_user_ops, struct object *use
     init_async_queue( &fd->wait_q );
     list_init( &fd->inode_entry );
     list_init( &fd->locks );
+    list_init( &fd->epoll_entry );
 
     if (!(fd->sync = create_internal_sync( 1, 1 )))
     {
@@ -93,6 +93,7 @@ struct shared_map
     struct fd      *fd;              /* file descriptor of the mapped PE file */
     struct file    *file;            /* temp file holding the shared data */
     struct list     entry;           /* entry in global shared maps list */
+    client_ptr_t    base;            /* address the image was relocated to (relocated images only) */
 };
 
 static void shared_map_dump( struct object *obj, int verbose );
@@ -124,6 +125,7 @@ static const struct object_ops shared_map_ops =
 };
 
 static struct list shared_map_list = LIST_INIT( shared_map_list );
+static struct list reloc_map_list = LIST_INIT( reloc_map_list );
 
 /* memory view mapped in client address space */
 struct memory_view
@@ -132,6 +134,7 @@ struct memory_view
     struct fd      *fd;              /* fd for mapped file */
     struct ranges  *committed;       /* list of committed ranges in this mapping */
     struct shared_map *shared;       /* temp file for shared PE mapping */
+    struct shared_map *reloc;        /* temp file for the relocated PE image */
     struct pe_image_info image;      /* image info (for PE image mapping) */
     unsigned int    flags;           /* SEC_* flags */
     client_ptr_t    base;            /* view base address (in process addr space) */
@@ -165,6 +168,7 @@ struct mapping
     struct pe_image_info image;      /* image info (for PE image mapping) */
     struct ranges       *committed;  /* list of committed ranges in this mapping */
     struct shared_map   *shared;     /* temp file for shared PE mapping */
+    struct shared_map   *reloc;      /* temp file for the relocated PE image */
     char                *exp_name;   /* export name (for PE image mapping) */
     void                *ver_res;    /* version resource (for PE image mapping) */
     data_size_t          exp_len;    /* length of export name (for PE image mapping) */
@@ -294,7 +298,8 @@ static void ranges_destroy( struct object *obj )
 static void shared_map_dump( struct object *obj, int verbose )
 {
     struct shared_map *shared = (struct shared_map *)obj;
-    fprintf( stderr, "Shared mapping fd=%p file=%p\n", shared->fd, shared->file );
+    fprintf( stderr, "Shared mapping fd=%p file=%p base=%08x%08x\n",
+             shared->fd, shared->file, (unsigned int)(shared->base >> 32), (unsigned int)shared->base );
 }
 
 static void shared_map_destroy( struct object *obj )
@@ -497,6 +502,7 @@ static void free_memory_view( struct memory_view *view )
     if (view->fd) release_object( view->fd );
     if (view->committed) release_object( view->committed );
     if (view->shared) release_object( view->shared );
+    if (view->reloc) release_object( view->reloc );
     list_remove( &view->entry );
     free( view );
 }
@@ -695,6 +701,7 @@ static int build_shared_mapping( struct mapping *mapping, size_t align_mask, int
     if (!(shared = alloc_object( &shared_map_ops ))) goto error;
     shared->fd = (struct fd *)grab_object( mapping->fd );
     shared->file = file;
+    shared->base = 0;
     list_add_head( &shared_map_list, &shared->entry );
     mapping->shared = shared;
     free( buffer );
@@ -706,6 +713,207 @@ static int build_shared_mapping( struct mapping *mapping, size_t align_mask, int
     return 0;
 }
 
+/* apply a block of base relocations to an image loaded in a buffer */
+static int apply_relocation_block( char *image, mem_size_t size, const IMAGE_BASE_RELOCATION *rel,
+                                   const USHORT *reloc, unsigned int count, client_ptr_t delta )
+{
+    for ( ; count; count--, reloc++)
+    {
+        mem_size_t offset = rel->VirtualAddress + (*reloc & 0xfff);
+        char *ptr = image + offset;
+
+        switch (*reloc >> 12)
+        {
+        case IMAGE_REL_BASED_ABSOLUTE:
+            break;
+        case IMAGE_REL_BASED_HIGH:
+            if (offset + sizeof(short) > size) return 0;
+            *(short *)ptr += HIWORD(delta);
+            break;
+        case IMAGE_REL_BASED_LOW:
+            if (offset + sizeof(short) > size) return 0;
+            *(short *)ptr += LOWORD(delta);
+            break;
+        case IMAGE_REL_BASED_HIGHLOW:
+            if (offset + sizeof(int) > size) return 0;
+            *(int *)ptr += delta;
+            break;
+        case IMAGE_REL_BASED_DIR64:
+            if (offset + sizeof(INT64) > size) return 0;
+            *(INT64 *)ptr += delta;
+            break;
+        case IMAGE_REL_BASED_THUMB_MOV32:
+        {
+            DWORD *inst = (DWORD *)ptr;
+            WORD lo, hi;
+            DWORD imm;
+
+            if (offset + 2 * sizeof(DWORD) > size) return 0;
+            lo = ((inst[0] << 1) & 0x0800) + ((inst[0] << 12) & 0xf000) +
+                 ((inst[0] >> 20) & 0x0700) + ((inst[0] >> 16) & 0x00ff);
+            hi = ((inst[1] << 1) & 0x0800) + ((inst[1] << 12) & 0xf000) +
+                 ((inst[1] >> 20) & 0x0700) + ((inst[1] >> 16) & 0x00ff);
+            imm = MAKELONG( lo, hi ) + delta;
+            lo = LOWORD( imm );
+            hi = HIWORD( imm );
+            inst[0] = (inst[0] & 0x8f00fbf0) + ((lo >> 1) & 0x0400) + ((lo >> 12) & 0x000f) +
+                                               ((lo << 20) & 0x70000000) + ((lo << 16) & 0xff0000);
+            inst[1] = (inst[1] & 0x8f00fbf0) + ((hi >> 1) & 0x0400) + ((hi >> 12) & 0x000f) +
+                                               ((hi << 20) & 0x70000000) + ((hi << 16) & 0xff0000);
+            break;
+        }
+        default:
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* load a PE image into a buffer the same way the client maps it, and relocate it to its map address */
+static int load_relocated_image( struct mapping *mapping, int unix_fd, char *image )
+{
+    static const unsigned int sector_align = 0x1ff;
+    mem_size_t total_size = mapping->image.map_size;
+    size_t align_mask = max( mapping->image.alignment - 1, page_mask );
+    size_t header_size, header_map_size, header_end, map_size, file_size;
+    client_ptr_t delta = mapping->image.map_addr - mapping->image.base;
+    IMAGE_SECTION_HEADER *sec = NULL;
+    IMAGE_DATA_DIRECTORY *dir = NULL;
+    IMAGE_NT_HEADERS32 *nt32;
+    IMAGE_NT_HEADERS64 *nt64;
+    IMAGE_DOS_HEADER *dos;
+    unsigned int i, nb_sec, pos, end;
+    off_t file_start;
+    struct stat st;
+    int ret = 0;
+
+    /* load the headers */
+
+    if (fstat( unix_fd, &st ) == -1) return 0;
+    header_size = min( mapping->image.header_size, st.st_size );
+    header_map_size = min( mapping->image.header_map_size, round_size( st.st_size, page_mask )) & ~page_mask;
+    header_end = min( round_size( header_size, align_mask ), total_size );
+    if (header_size > total_size) return 0;
+    if (pread( unix_fd, image, min( max( header_size, header_map_size ), st.st_size ), 0 ) < (long)header_size)
+        return 0;
+    memset( image + header_size, 0, header_end - header_size );
+
+    dos = (IMAGE_DOS_HEADER *)image;
+    if ((unsigned int)dos->e_lfanew >= header_end || header_end - dos->e_lfanew < sizeof(*nt64)) return 0;
+    nt32 = (IMAGE_NT_HEADERS32 *)(image + dos->e_lfanew);
+    nt64 = (IMAGE_NT_HEADERS64 *)nt32;
+    nb_sec = nt32->FileHeader.NumberOfSections;
+    pos = dos->e_lfanew + FIELD_OFFSET( IMAGE_NT_HEADERS32, OptionalHeader ) + nt32->FileHeader.SizeOfOptionalHeader;
+    if (pos + nb_sec * sizeof(*sec) > header_end) return 0;
+    if (!(sec = memdup( image + pos, nb_sec * sizeof(*sec) ))) return 0;
+
+    /* load the sections */
+
+    for (i = 0; i < nb_sec; i++)
+    {
+        get_section_sizes( &sec[i], align_mask, &map_size, &file_start, &file_size );
+        if (sec[i].VirtualAddress > total_size || map_size > total_size - sec[i].VirtualAddress) goto done;
+        if (!sec[i].PointerToRawData || !file_size) continue;
+        if (sec[i].PointerToRawData >= st.st_size ||
+            file_start + file_size > ((st.st_size + sector_align) & ~sector_align)) goto done;
+        if (pread( unix_fd, image + sec[i].VirtualAddress, file_size, file_start ) == -1) goto done;
+        if (file_size & align_mask)
+        {
+            size_t zero_end = min( round_size( file_size, align_mask ), map_size );
+            memset( image + sec[i].VirtualAddress + file_size, 0, zero_end - file_size );
+        }
+    }
+
+    /* relocate to the map address */
+
+    switch (nt32->OptionalHeader.Magic)
+    {
+    case IMAGE_NT_OPTIONAL_HDR32_MAGIC:
+        nt32->OptionalHeader.ImageBase = mapping->image.map_addr;
+        if (IMAGE_DIRECTORY_ENTRY_BASERELOC < nt32->OptionalHeader.NumberOfRvaAndSizes)
+            dir = &nt32->OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_BASERELOC];
+        break;
+    case IMAGE_NT_OPTIONAL_HDR64_MAGIC:
+        nt64->OptionalHeader.ImageBase = mapping->image.map_addr;
+        if (IMAGE_DIRECTORY_ENTRY_BASERELOC < nt64->OptionalHeader.NumberOfRvaAndSizes)
+            dir = &nt64->OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_BASERELOC];
+        break;
+    default:
+        goto done;
+    }
+
+    if (dir && dir->VirtualAddress && dir->Size &&
+        dir->VirtualAddress < total_size && dir->Size <= total_size - dir->VirtualAddress)
+    {
+        pos = dir->VirtualAddress;
+        end = dir->VirtualAddress + dir->Size;
+        while (end - pos > sizeof(IMAGE_BASE_RELOCATION))
+        {
+            IMAGE_BASE_RELOCATION *rel = (IMAGE_BASE_RELOCATION *)(image + pos);
+            unsigned int count;
+
+            if (!rel->SizeOfBlock || rel->VirtualAddress >= total_size) break;
+            if (rel->SizeOfBlock < sizeof(*rel)) goto done;
+            count = (rel->SizeOfBlock - sizeof(*rel)) / sizeof(USHORT);
+            if (count > (total_size - pos - sizeof(*rel)) / sizeof(USHORT)) goto done;
+            if (!apply_relocation_block( image, total_size, rel, (const USHORT *)(rel + 1), count, delta ))
+                goto done;
+            pos += sizeof(*rel) + count * sizeof(USHORT);
+        }
+    }
+    ret = 1;
+
+done:
+    free( sec );
+    return ret;
+}
+
+/* find or create the temp file holding the relocated copy of a PE image */
+static struct shared_map *get_reloc_file( struct mapping *mapping )
+{
+    struct shared_map *reloc;
+    struct file *file;
+    char *image;
+    int unix_fd, reloc_fd;
+
+    LIST_FOR_EACH_ENTRY( reloc, &reloc_map_list, struct shared_map, entry )
+        if (reloc->base == mapping->image.map_addr && is_same_file_fd( reloc->fd, mapping->fd ))
+            return (struct shared_map *)grab_object( reloc );
+
+    /* the shared sections would need to be relocated too */
+    if (mapping->shared || mapping->image.is_hybrid) return NULL;
+    if (mapping->image.image_flags & IMAGE_FLAGS_ImageMappedFlat) return NULL;
+    if ((unix_fd = get_unix_fd( mapping->fd )) == -1) return NULL;
+    if (!(image = calloc( 1, mapping->image.map_size ))) return NULL;
+
+    /* the server builds the contents itself, so no client can feed bad pages to the other processes */
+    if (!load_relocated_image( mapping, unix_fd, image ) ||
+        (reloc_fd = create_temp_file( mapping->image.map_size )) == -1)
+    {
+        free( image );
+        return NULL;
+    }
+    if (pwrite( reloc_fd, image, mapping->image.map_size, 0 ) != mapping->image.map_size)
+    {
+        close( reloc_fd );
+        free( image );
+        return NULL;
+    }
+    free( image );
+
+    if (!(file = create_file_for_fd( reloc_fd, FILE_GENERIC_READ, 0 ))) return NULL;
+    if (!(reloc = alloc_object( &shared_map_ops )))
+    {
+        release_object( file );
+        return NULL;
+    }
+    reloc->fd   = (struct fd *)grab_object( mapping->fd );
+    reloc->file = file;
+    reloc->base = mapping->image.map_addr;
+    list_add_head( &reloc_map_list, &reloc->entry );
+    return reloc;
+}
+
 /* load a data directory header from its section */
 static int load_data_dir( void *dir, size_t dir_size, size_t va, size_t size, size_t align_mask,
                           int unix_fd, IMAGE_SECTION_HEADER *sec, unsigned int nb_sec )
@@ -1134,6 +1342,7 @@ static struct mapping *create_mapping( struct object *root, const struct unicode
     mapping->size        = size;
     mapping->fd          = NULL;
     mapping->shared      = NULL;
+    mapping->reloc       = NULL;
     mapping->committed   = NULL;
     mapping->exp_name    = NULL;
     mapping->ver_res     = NULL;
@@ -1227,6 +1436,7 @@ struct mapping *create_fd_mapping( struct object *root, const struct unicode_str
     if (get_error() == STATUS_OBJECT_NAME_EXISTS) return mapping;  /* Nothing else to do */
 
     mapping->shared    = NULL;
+    mapping->reloc     = NULL;
     mapping->committed = NULL;
     mapping->exp_name  = NULL;
     mapping->ver_res   = NULL;
@@ -1343,6 +1553,7 @@ static void mapping_destroy( struct object *obj )
     if (mapping->fd) release_object( mapping->fd );
     if (mapping->committed) release_object( mapping->committed );
     if (mapping->shared) release_object( mapping->shared );
+    if (mapping->reloc) release_object( mapping->reloc );
     free( mapping->exp_name );
     free( mapping->ver_res );
 }
@@ -1671,6 +1882,26 @@ DECL_HANDLER(get_mapping_info)
     release_object( mapping );
 }
 
+/* get the temp file holding a copy of an image mapping relocated to its map address */
+DECL_HANDLER(get_image_reloc_file)
+{
+    struct mapping *mapping;
+
+    if (!(mapping = get_mapping_obj( current->process, req->handle, SECTION_MAP_READ ))) return;
+
+    if (!(mapping->flags & SEC_IMAGE) || !mapping->image.map_addr)
+    {
+        set_error( STATUS_INVALID_PARAMETER );
+        release_object( mapping );
+        return;
+    }
+
+    if (!mapping->reloc) mapping->reloc = get_reloc_file( mapping );
+    if (mapping->reloc)
+        reply->file = alloc_handle( current->process, mapping->reloc->file, GENERIC_READ, 0 );
+    release_object( mapping );
+}
+
 /* get the address to use to map an image mapping */
 DECL_HANDLER(get_image_map_address)
 {
@@ -1722,6 +1953,7 @@ DECL_HANDLER(map_view)
         view->fd        = !is_fd_removable( mapping->fd ) ? (struct fd *)grab_object( mapping->fd ) : NULL;
         view->committed = mapping->committed ? (struct ranges *)grab_object( mapping->committed ) : NULL;
         view->shared    = NULL;
+        view->reloc     = NULL;
         add_process_view( current, view );
     }
 
@@ -1759,6 +1991,9 @@ DECL_HANDLER(map_image_view)
         view->fd        = !is_fd_removable( mapping->fd ) ? (struct fd *)grab_object( mapping->fd ) : NULL;
         view->committed = NULL;
         view->shared    = mapping->shared ? (struct shared_map *)grab_object( mapping->shared ) : NULL;
+        /* keep the relocated copy around for other processes as long as it's mapped somewhere */
+        view->reloc     = (mapping->reloc && view->base == mapping->reloc->base) ?
+                          (struct shared_map *)grab_object( mapping->reloc ) : NULL;
         view->image     = mapping->image;
         if (add_process_view( current, view ))
         {
@@ -690,6 +690,7 @@ struct process *create_process( int fd, struct process *parent, unsigned int fla
     process->idle_event      = NULL;
     process->peb             = 0;
     process->dir_cache       = NULL;
+    process->req_stats       = NULL;
     process->winstation      = 0;
     process->desktop         = 0;
     process->token           = NULL;
@@ -799,9 +800,24 @@ static void process_destroy( struct object *obj )
     list_remove( &process->rawinput_entry );
     free( process->rawinput_devices );
     free( process->dir_cache );
+    free( process->req_stats );
     free( process->image );
 }
 
+/* dump the request statistics of all running processes */
+void dump_process_request_stats(void)
+{
+    struct process *process;
+    char name[64];
+
+    LIST_FOR_EACH_ENTRY( process, &process_list, struct process, entry )
+    {
+        if (!process->req_stats) continue;
+        snprintf( name, sizeof(name), "process %04x (pid %d)", process->id, process->unix_pid );
+        print_request_stats( name, process->req_stats );
+    }
+}
+
 /* dump a process on stdout for debugging purposes */
 static void process_dump( struct object *obj, int verbose )
 {
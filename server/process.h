@@ -80,6 +80,7 @@ struct process
     struct list          views;           /* list of memory views */
     client_ptr_t         peb;             /* PEB address in client address space */
     struct dir_cache    *dir_cache;       /* map of client-side directory cache */
+    struct request_stats *req_stats;      /* statistics of the requests made by the process */
     unsigned int         trace_data;      /* opaque data used by the process tracing mechanism */
     struct rawinput_device *rawinput_devices;     /* list of registered rawinput devices */
     unsigned int         rawinput_device_count;   /* number of registered rawinput devices */
@@ -107,6 +108,7 @@ extern struct debug_obj *get_debug_obj( struct process *process, obj_handle_t ha
 extern int process_set_debugger( struct process *process, struct thread *thread );
 extern void debugger_detach( struct process *process, struct debug_obj *debug_obj );
 extern int set_process_debug_flag( struct process *process, int flag );
+extern void dump_process_request_stats(void);
 
 extern void add_process_thread( struct process *process,
                                 struct thread *thread );
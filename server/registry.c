@@ -1095,6 +1095,38 @@ static int delete_key( struct key *key, int recurse )
     return 1;
 }
 
+/* delete all the values and subkeys of a key; volatile subkeys are kept since
+ * saved branches never contain them */
+static int clear_key( struct key *key )
+{
+    int i;
+
+    if (key->flags & KEY_PREDEF)
+    {
+        set_error( STATUS_INVALID_HANDLE );
+        return 0;
+    }
+
+    for (i = key->last_subkey; i >= 0; i--)
+    {
+        if (key->subkeys[i]->flags & KEY_VOLATILE) continue;
+        if (!delete_key( key->subkeys[i], 1 )) return 0;
+    }
+
+    if (key->last_value >= 0)
+    {
+        if (debug_level > 1) dump_operation( key, NULL, "Clear" );
+        for (i = 0; i <= key->last_value; i++)
+        {
+            free( key->values[i].name );
+            free( key->values[i].data );
+        }
+        key->last_value = -1;
+        touch_key( key, REG_NOTIFY_CHANGE_LAST_SET );
+    }
+    return 1;
+}
+
 /* try to grow the array of values; return 1 if OK, 0 on error */
 static int grow_values( struct key *key )
 {
@@ -2402,6 +2434,28 @@ DECL_HANDLER(save_registry)
     }
 }
 
+DECL_HANDLER(restore_registry)
+{
+    struct key *key;
+    struct file *file;
+
+    if (!thread_single_check_privilege( current, SeRestorePrivilege ))
+    {
+        set_error( STATUS_PRIVILEGE_NOT_HELD );
+        return;
+    }
+
+    if (!(file = get_file_obj( current->process, req->file, FILE_READ_DATA ))) return;
+    release_object( file );
+
+    if ((key = get_hkey_obj( req->hkey, 0 )))
+    {
+        /* the saved branch replaces the contents of the key */
+        if (clear_key( key )) load_registry( key, req->file );
+        release_object( key );
+    }
+}
+
 /* add a registry key change notification */
 DECL_HANDLER(set_registry_notification)
 {
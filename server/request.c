@@ -123,9 +123,11 @@ timeout_t server_start_time = 0;  /* server startup time */
 char *server_dir = NULL;   /* server directory */
 int server_dir_fd = -1;    /* file descriptor for the server dir */
 int config_dir_fd = -1;    /* file descriptor for the config dir */
+int collect_request_stats = 0;  /* collect per-request statistics */
 
 static struct master_socket *master_socket;  /* the master socket object */
 static struct timeout_user *master_timeout;
+static struct request_stats req_stats[REQ_NB_REQUESTS];  /* statistics per request type */
 
 /* complain about a protocol error and terminate the client connection */
 void fatal_protocol_error( struct thread *thread, const char *err, ... )
@@ -287,11 +289,81 @@ static void send_reply( union generic_reply *reply )
         fatal_protocol_error( current, "reply write: %s\n", strerror( errno ));
 }
 
+/* add a request to the statistics */
+static void add_request_stats( struct request_stats *stats, timeout_t time,
+                               data_size_t bytes_in, data_size_t bytes_out )
+{
+    stats->count++;
+    stats->total_time += time;
+    if (time > stats->max_time) stats->max_time = time;
+    stats->bytes_in += bytes_in;
+    stats->bytes_out += bytes_out;
+}
+
+/* update the statistics of a request type and of the client process */
+static void update_request_stats( struct thread *thread, enum request req, timeout_t time,
+                                  data_size_t bytes_out )
+{
+    struct process *process = thread->process;
+    data_size_t bytes_in = sizeof(thread->req) + thread->req.request_header.request_size;
+
+    if (req < REQ_NB_REQUESTS) add_request_stats( &req_stats[req], time, bytes_in, bytes_out );
+    if (!process->req_stats && !(process->req_stats = calloc( 1, sizeof(*process->req_stats) ))) return;
+    add_request_stats( process->req_stats, time, bytes_in, bytes_out );
+}
+
+/* print a line of request statistics */
+void print_request_stats( const char *name, const struct request_stats *stats )
+{
+    fprintf( stderr, "%-32s %10u %12.3f %10.3f %14llu %14llu\n", name, stats->count,
+             stats->total_time / 10000.0, stats->max_time / 10000.0, stats->bytes_in, stats->bytes_out );
+}
+
+static int compare_request_time( const void *p1, const void *p2 )
+{
+    const struct request_stats *stats1 = &req_stats[*(const enum request *)p1];
+    const struct request_stats *stats2 = &req_stats[*(const enum request *)p2];
+
+    if (stats1->total_time > stats2->total_time) return -1;
+    if (stats1->total_time < stats2->total_time) return 1;
+    return 0;
+}
+
+/* dump the request statistics collected so far, sorted by total time */
+void dump_request_stats(void)
+{
+    enum request order[REQ_NB_REQUESTS];
+    struct request_stats total = { 0 };
+    unsigned int i, count = 0;
+
+    for (i = 0; i < REQ_NB_REQUESTS; i++)
+    {
+        if (!req_stats[i].count) continue;
+        order[count++] = i;
+        total.count += req_stats[i].count;
+        total.total_time += req_stats[i].total_time;
+        total.max_time = max( total.max_time, req_stats[i].max_time );
+        total.bytes_in += req_stats[i].bytes_in;
+        total.bytes_out += req_stats[i].bytes_out;
+    }
+    qsort( order, count, sizeof(order[0]), compare_request_time );
+
+    fprintf( stderr, "wineserver: request statistics (times in ms)\n" );
+    fprintf( stderr, "%-32s %10s %12s %10s %14s %14s\n", "request", "count", "total", "max", "bytes in", "bytes out" );
+    for (i = 0; i < count; i++) print_request_stats( get_request_name( order[i] ), &req_stats[order[i]] );
+    print_request_stats( "total", &total );
+    dump_process_request_stats();
+}
+
 /* call a request handler */
 static void call_req_handler( struct thread *thread )
 {
     union generic_reply reply;
     enum request req = thread->req.request_header.req;
+    data_size_t reply_size = 0;
+    timeout_t start = 0;
+
+    if (collect_request_stats) start = monotonic_counter();
 
     current = thread;
     current->reply_size = 0;
@@ -312,6 +384,7 @@ static void call_req_handler( struct thread *thread )
             reply.reply_header.error = current->error;
             reply.reply_header.reply_size = current->reply_size;
             if (debug_level) trace_reply( req, &reply );
+            reply_size = sizeof(reply) + current->reply_size;
             send_reply( &reply );
         }
         else
@@ -321,6 +394,8 @@ static void call_req_handler( struct thread *thread )
         }
     }
     current = NULL;
+
+    if (collect_request_stats) update_request_stats( thread, req, monotonic_counter() - start, reply_size );
 }
 
 /* read a request from a thread */
@@ -907,6 +982,7 @@ static void close_socket_timeout( void *arg )
     master_timeout = NULL;
     flush_registry();
     if (debug_level) fprintf( stderr, "wineserver: exiting (pid=%ld)\n", (long) getpid() );
+    if (collect_request_stats) dump_request_stats();
 
 #ifdef DEBUG_OBJECTS
     close_objects();  /* shut down everything properly */
@@ -65,6 +65,21 @@ extern int server_dir_fd, config_dir_fd;
 
 extern void trace_request(void);
 extern void trace_reply( enum request req, const union generic_reply *reply );
+extern const char *get_request_name( enum request req );
+
+/* request statistics, collected when collect_request_stats is set */
+struct request_stats
+{
+    unsigned int       count;       /* number of requests */
+    timeout_t          total_time;  /* total time spent handling them */
+    timeout_t          max_time;    /* longest time spent handling one of them */
+    unsigned long long bytes_in;    /* number of request bytes received */
+    unsigned long long bytes_out;   /* number of reply bytes sent */
+};
+
+extern int collect_request_stats;
+extern void print_request_stats( const char *name, const struct request_stats *stats );
+extern void dump_request_stats(void);
 
 /* get current tick count to return to client */
 static inline unsigned int get_tick_count(void)
@@ -74,6 +74,7 @@ DECL_HANDLER(create_mapping);
 DECL_HANDLER(open_mapping);
 DECL_HANDLER(get_mapping_info);
 DECL_HANDLER(get_image_map_address);
+DECL_HANDLER(get_image_reloc_file);
 DECL_HANDLER(map_view);
 DECL_HANDLER(map_image_view);
 DECL_HANDLER(map_builtin_view);
@@ -105,6 +106,7 @@ DECL_HANDLER(delete_key_value);
 DECL_HANDLER(load_registry);
 DECL_HANDLER(unload_registry);
 DECL_HANDLER(save_registry);
+DECL_HANDLER(restore_registry);
 DECL_HANDLER(set_registry_notification);
 DECL_HANDLER(rename_key);
 DECL_HANDLER(create_timer);
@@ -384,6 +386,7 @@ static const req_handler req_handlers[REQ_NB_REQUESTS] =
     (req_handler)req_open_mapping,
     (req_handler)req_get_mapping_info,
     (req_handler)req_get_image_map_address,
+    (req_handler)req_get_image_reloc_file,
     (req_handler)req_map_view,
     (req_handler)req_map_image_view,
     (req_handler)req_map_builtin_view,
@@ -415,6 +418,7 @@ static const req_handler req_handlers[REQ_NB_REQUESTS] =
     (req_handler)req_load_registry,
     (req_handler)req_unload_registry,
     (req_handler)req_save_registry,
+    (req_handler)req_restore_registry,
     (req_handler)req_set_registry_notification,
     (req_handler)req_rename_key,
     (req_handler)req_create_timer,
@@ -1032,6 +1036,7 @@ C_ASSERT( sizeof(struct recv_socket_request) == 64 );
 C_ASSERT( offsetof(struct recv_socket_reply, wait) == 8 );
 C_ASSERT( offsetof(struct recv_socket_reply, options) == 12 );
 C_ASSERT( offsetof(struct recv_socket_reply, nonblocking) == 16 );
+C_ASSERT( offsetof(struct recv_socket_reply, icmp_over_dgram) == 20 );
 C_ASSERT( sizeof(struct recv_socket_reply) == 24 );
 C_ASSERT( offsetof(struct send_socket_request, flags) == 12 );
 C_ASSERT( offsetof(struct send_socket_request, async) == 16 );
@@ -1039,6 +1044,8 @@ C_ASSERT( sizeof(struct send_socket_request) == 56 );
 C_ASSERT( offsetof(struct send_socket_reply, wait) == 8 );
 C_ASSERT( offsetof(struct send_socket_reply, options) == 12 );
 C_ASSERT( offsetof(struct send_socket_reply, nonblocking) == 16 );
+C_ASSERT( offsetof(struct send_socket_reply, type) == 20 );
+C_ASSERT( offsetof(struct send_socket_reply, icmp_over_dgram) == 22 );
 C_ASSERT( sizeof(struct send_socket_reply) == 24 );
 C_ASSERT( offsetof(struct socket_get_events_request, handle) == 12 );
 C_ASSERT( offsetof(struct socket_get_events_request, event) == 16 );
@@ -1100,6 +1107,10 @@ C_ASSERT( offsetof(struct get_image_map_address_request, handle) == 12 );
 C_ASSERT( sizeof(struct get_image_map_address_request) == 16 );
 C_ASSERT( offsetof(struct get_image_map_address_reply, addr) == 8 );
 C_ASSERT( sizeof(struct get_image_map_address_reply) == 16 );
+C_ASSERT( offsetof(struct get_image_reloc_file_request, handle) == 12 );
+C_ASSERT( sizeof(struct get_image_reloc_file_request) == 16 );
+C_ASSERT( offsetof(struct get_image_reloc_file_reply, file) == 8 );
+C_ASSERT( sizeof(struct get_image_reloc_file_reply) == 16 );
 C_ASSERT( offsetof(struct map_view_request, mapping) == 12 );
 C_ASSERT( offsetof(struct map_view_request, access) == 16 );
 C_ASSERT( offsetof(struct map_view_request, base) == 24 );
@@ -1244,6 +1255,9 @@ C_ASSERT( sizeof(struct unload_registry_request) == 24 );
 C_ASSERT( offsetof(struct save_registry_request, hkey) == 12 );
 C_ASSERT( offsetof(struct save_registry_request, file) == 16 );
 C_ASSERT( sizeof(struct save_registry_request) == 24 );
+C_ASSERT( offsetof(struct restore_registry_request, hkey) == 12 );
+C_ASSERT( offsetof(struct restore_registry_request, file) == 16 );
+C_ASSERT( sizeof(struct restore_registry_request) == 24 );
 C_ASSERT( offsetof(struct set_registry_notification_request, hkey) == 12 );
 C_ASSERT( offsetof(struct set_registry_notification_request, event) == 16 );
 C_ASSERT( offsetof(struct set_registry_notification_request, subtree) == 20 );
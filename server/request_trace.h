@@ -21,6 +21,7 @@ static void dump_varargs_acl( const char *prefix, data_size_t size );
 static void dump_varargs_apc_call( const char *prefix, data_size_t size );
 static void dump_varargs_apc_result( const char *prefix, data_size_t size );
 static void dump_varargs_bytes( const char *prefix, data_size_t size );
+static void dump_varargs_completion_msgs( const char *prefix, data_size_t size );
 static void dump_varargs_contexts( const char *prefix, data_size_t size );
 static void dump_varargs_cursor_positions( const char *prefix, data_size_t size );
 static void dump_varargs_debug_event( const char *prefix, data_size_t size );
@@ -765,6 +766,7 @@ static void dump_recv_socket_reply( const struct recv_socket_reply *req )
     fprintf( stderr, " wait=%04x", req->wait );
     fprintf( stderr, ", options=%08x", req->options );
     fprintf( stderr, ", nonblocking=%d", req->nonblocking );
+    fprintf( stderr, ", icmp_over_dgram=%d", req->icmp_over_dgram );
 }
 
 static void dump_send_socket_request( const struct send_socket_request *req )
@@ -778,6 +780,8 @@ static void dump_send_socket_reply( const struct send_socket_reply *req )
     fprintf( stderr, " wait=%04x", req->wait );
     fprintf( stderr, ", options=%08x", req->options );
     fprintf( stderr, ", nonblocking=%d", req->nonblocking );
+    fprintf( stderr, ", type=%04x", req->type );
+    fprintf( stderr, ", icmp_over_dgram=%04x", req->icmp_over_dgram );
 }
 
 static void dump_socket_get_events_request( const struct socket_get_events_request *req )
@@ -903,6 +907,16 @@ static void dump_get_image_map_address_reply( const struct get_image_map_address
     dump_uint64( " addr=", &req->addr );
 }
 
+static void dump_get_image_reloc_file_request( const struct get_image_reloc_file_request *req )
+{
+    fprintf( stderr, " handle=%04x", req->handle );
+}
+
+static void dump_get_image_reloc_file_reply( const struct get_image_reloc_file_reply *req )
+{
+    fprintf( stderr, " file=%04x", req->file );
+}
+
 static void dump_map_view_request( const struct map_view_request *req )
 {
     fprintf( stderr, " mapping=%04x", req->mapping );
@@ -1205,6 +1219,12 @@ static void dump_save_registry_request( const struct save_registry_request *req
     fprintf( stderr, ", file=%04x", req->file );
 }
 
+static void dump_restore_registry_request( const struct restore_registry_request *req )
+{
+    fprintf( stderr, " hkey=%04x", req->hkey );
+    fprintf( stderr, ", file=%04x", req->file );
+}
+
 static void dump_set_registry_notification_request( const struct set_registry_notification_request *req )
 {
     fprintf( stderr, " hkey=%04x", req->hkey );
@@ -3119,6 +3139,7 @@ static void dump_remove_completion_reply( const struct remove_completion_reply *
     dump_uint64( ", information=", &req->information );
     fprintf( stderr, ", status=%08x", req->status );
     fprintf( stderr, ", wait_handle=%04x", req->wait_handle );
+    dump_varargs_completion_msgs( ", msgs=", cur_size );
 }
 
 static void dump_get_thread_completion_request( const struct get_thread_completion_request *req )
@@ -3131,6 +3152,7 @@ static void dump_get_thread_completion_reply( const struct get_thread_completion
     dump_uint64( ", cvalue=", &req->cvalue );
     dump_uint64( ", information=", &req->information );
     fprintf( stderr, ", status=%08x", req->status );
+    dump_varargs_completion_msgs( ", msgs=", cur_size );
 }
 
 static void dump_query_completion_request( const struct query_completion_request *req )
@@ -3583,6 +3605,7 @@ static const dump_func req_dumpers[REQ_NB_REQUESTS] =
     (dump_func)dump_open_mapping_request,
     (dump_func)dump_get_mapping_info_request,
     (dump_func)dump_get_image_map_address_request,
+    (dump_func)dump_get_image_reloc_file_request,
     (dump_func)dump_map_view_request,
     (dump_func)dump_map_image_view_request,
     (dump_func)dump_map_builtin_view_request,
@@ -3614,6 +3637,7 @@ static const dump_func req_dumpers[REQ_NB_REQUESTS] =
     (dump_func)dump_load_registry_request,
     (dump_func)dump_unload_registry_request,
     (dump_func)dump_save_registry_request,
+    (dump_func)dump_restore_registry_request,
     (dump_func)dump_set_registry_notification_request,
     (dump_func)dump_rename_key_request,
     (dump_func)dump_create_timer_request,
@@ -3893,6 +3917,7 @@ static const dump_func reply_dumpers[REQ_NB_REQUESTS] =
     (dump_func)dump_open_mapping_reply,
     (dump_func)dump_get_mapping_info_reply,
     (dump_func)dump_get_image_map_address_reply,
+    (dump_func)dump_get_image_reloc_file_reply,
     NULL,
     NULL,
     NULL,
@@ -3926,6 +3951,7 @@ static const dump_func reply_dumpers[REQ_NB_REQUESTS] =
     NULL,
     NULL,
     NULL,
+    NULL,
     (dump_func)dump_create_timer_reply,
     (dump_func)dump_open_timer_reply,
     (dump_func)dump_set_timer_reply,
@@ -4203,6 +4229,7 @@ static const char * const req_names[REQ_NB_REQUESTS] =
     "open_mapping",
     "get_mapping_info",
     "get_image_map_address",
+    "get_image_reloc_file",
     "map_view",
     "map_image_view",
     "map_builtin_view",
@@ -4234,6 +4261,7 @@ static const char * const req_names[REQ_NB_REQUESTS] =
     "load_registry",
     "unload_registry",
     "save_registry",
+    "restore_registry",
     "set_registry_notification",
     "rename_key",
     "create_timer",
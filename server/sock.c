@@ -166,6 +166,17 @@ union unix_sockaddr
 
 static struct list poll_list = LIST_INIT( poll_list );
 
+struct poll_socket
+{
+    struct list entry;            /* entry in the socket's list of polls */
+    struct poll_req *req;
+    struct sock *sock;
+    int mask;
+    obj_handle_t handle;
+    int flags;
+    unsigned int status;
+};
+
 struct poll_req
 {
     struct list entry;
@@ -176,14 +187,7 @@ struct poll_req
     int exclusive;
     int pending;
     unsigned int count;
-    struct
-    {
-        struct sock *sock;
-        int mask;
-        obj_handle_t handle;
-        int flags;
-        unsigned int status;
-    } sockets[1];
+    struct poll_socket sockets[1];
 };
 
 struct accept_req
@@ -272,6 +276,7 @@ struct sock
     struct accept_req  *accept_recv_req; /* pending accept-into request which will recv on this socket */
     struct connect_req *connect_req; /* pending connection request */
     struct poll_req    *main_poll;   /* main poll */
+    struct list         poll_sockets; /* entries of poll requests waiting on this socket */
     union win_sockaddr  addr;        /* socket name */
     int                 addr_len;    /* socket name length */
     union win_sockaddr  peer_addr;   /* peer name */
@@ -298,6 +303,7 @@ struct sock
     unsigned int        reset : 1;   /* did we get a TCP reset? */
     unsigned int        reuseaddr : 1; /* winsock SO_REUSEADDR option value */
     unsigned int        exclusiveaddruse : 1; /* winsock SO_EXCLUSIVEADDRUSE option value */
+    unsigned int        icmp_over_dgram : 1; /* ICMP socket emulated with an unprivileged SOCK_DGRAM socket */
 };
 
 static int is_tcp_socket( struct sock *sock )
@@ -1108,7 +1114,10 @@ static void free_poll_req( void *private )
     if (req->timeout) remove_timeout_user( req->timeout );
 
     for (i = 0; i < req->count; ++i)
+    {
+        list_remove( &req->sockets[i].entry );
         release_object( req->sockets[i].sock );
+    }
     release_object( req->async );
     release_object( req->iosb );
     list_remove( &req->entry );
@@ -1230,31 +1239,28 @@ static void complete_async_poll( struct poll_req *req, unsigned int status )
 static void complete_async_polls( struct sock *sock, int event, int error )
 {
     int flags = get_poll_flags( sock, event );
-    struct poll_req *req, *next;
+    struct poll_socket *poll_sock;
 
-    LIST_FOR_EACH_ENTRY_SAFE( req, next, &poll_list, struct poll_req, entry )
+    /* completing a poll may free it and unlink its entries, so start over after each one */
+restart:
+    LIST_FOR_EACH_ENTRY( poll_sock, &sock->poll_sockets, struct poll_socket, entry )
     {
-        unsigned int i;
+        struct poll_req *req = poll_sock->req;
 
         if (req->iosb->status != STATUS_PENDING) continue;
+        if (!(poll_sock->mask & flags)) continue;
 
-        for (i = 0; i < req->count; ++i)
-        {
-            if (req->sockets[i].sock != sock) continue;
-            if (!(req->sockets[i].mask & flags)) continue;
-
-            if (debug_level)
-                fprintf( stderr, "completing poll for socket %p, wanted %#x got %#x\n",
-                         sock, req->sockets[i].mask, flags );
+        if (debug_level)
+            fprintf( stderr, "completing poll for socket %p, wanted %#x got %#x\n",
+                     sock, poll_sock->mask, flags );
 
-            req->sockets[i].flags = req->sockets[i].mask & flags;
-            req->sockets[i].status = sock_get_ntstatus( error );
+        poll_sock->flags = poll_sock->mask & flags;
+        poll_sock->status = sock_get_ntstatus( error );
 
-            if (req->pending)
-            {
-                complete_async_poll( req, STATUS_SUCCESS );
-                break;
-            }
+        if (req->pending)
+        {
+            complete_async_poll( req, STATUS_SUCCESS );
+            goto restart;
         }
     }
 }
@@ -1540,7 +1546,7 @@ static int sock_get_poll_events( struct fd *fd )
 {
     struct sock *sock = get_fd_user( fd );
     unsigned int mask = sock->mask & ~sock->reported_events;
-    struct poll_req *req;
+    struct poll_socket *poll_sock;
     int ev = 0;
 
     assert( sock->obj.ops == &sock_ops );
@@ -1548,18 +1554,11 @@ static int sock_get_poll_events( struct fd *fd )
     if (!sock->type) /* not initialized yet */
         return -1;
 
-    LIST_FOR_EACH_ENTRY( req, &poll_list, struct poll_req, entry )
+    LIST_FOR_EACH_ENTRY( poll_sock, &sock->poll_sockets, struct poll_socket, entry )
     {
-        unsigned int i;
-
-        if (req->iosb->status != STATUS_PENDING) continue;
-
-        for (i = 0; i < req->count; ++i)
-        {
-            if (req->sockets[i].sock != sock) continue;
+        if (poll_sock->req->iosb->status != STATUS_PENDING) continue;
 
-            ev |= poll_flags_from_afd( sock, req->sockets[i].mask );
-        }
+        ev |= poll_flags_from_afd( sock, poll_sock->mask );
     }
 
     switch (sock->state)
@@ -1709,7 +1708,7 @@ static int sock_close_handle( struct object *obj, struct process *process, obj_h
     if (sock->obj.handle_count == 1) /* last handle */
     {
         struct accept_req *accept_req, *accept_next;
-        struct poll_req *poll_req, *poll_next;
+        struct poll_socket *poll_sock;
 
         if (sock->accept_recv_req)
             async_terminate( sock->accept_recv_req->async, STATUS_CANCELLED );
@@ -1720,25 +1719,26 @@ static int sock_close_handle( struct object *obj, struct process *process, obj_h
         if (sock->connect_req)
             async_terminate( sock->connect_req->async, STATUS_CANCELLED );
 
-        LIST_FOR_EACH_ENTRY_SAFE( poll_req, poll_next, &poll_list, struct poll_req, entry )
+    restart:
+        LIST_FOR_EACH_ENTRY( poll_sock, &sock->poll_sockets, struct poll_socket, entry )
         {
-            struct iosb *iosb = poll_req->iosb;
-            BOOL signaled = FALSE;
+            struct poll_req *poll_req = poll_sock->req;
             unsigned int i;
 
-            if (iosb->status != STATUS_PENDING) continue;
+            if (poll_req->iosb->status != STATUS_PENDING) continue;
 
             for (i = 0; i < poll_req->count; ++i)
             {
                 if (poll_req->sockets[i].sock == sock)
                 {
-                    signaled = TRUE;
                     poll_req->sockets[i].flags = AFD_POLL_CLOSE;
                     poll_req->sockets[i].status = 0;
                 }
             }
 
-            if (signaled) complete_async_poll( poll_req, STATUS_SUCCESS );
+            /* completing the poll may free it and unlink its entries */
+            complete_async_poll( poll_req, STATUS_SUCCESS );
+            goto restart;
         }
     }
     return async_close_obj_handle( obj, process, handle );
@@ -1800,6 +1800,7 @@ static struct sock *create_socket(void)
     sock->accept_recv_req = NULL;
     sock->connect_req = NULL;
     sock->main_poll = NULL;
+    list_init( &sock->poll_sockets );
     memset( &sock->addr, 0, sizeof(sock->addr) );
     sock->addr_len = 0;
     memset( &sock->peer_addr, 0, sizeof(sock->peer_addr) );
@@ -1814,6 +1815,7 @@ static struct sock *create_socket(void)
     sock->reset = 0;
     sock->reuseaddr = 0;
     sock->exclusiveaddruse = 0;
+    sock->icmp_over_dgram = 0;
     sock->rcvbuf = 0;
     sock->sndbuf = 0;
     sock->rcvtimeo = 0;
@@ -1926,6 +1928,7 @@ static int init_socket( struct sock *sock, int family, int type, int protocol )
     unix_family = get_unix_family( family );
     unix_type = get_unix_type( type );
     unix_protocol = get_unix_protocol( family, protocol );
+    sock->icmp_over_dgram = 0;
 
     if (unix_protocol < 0)
     {
@@ -1957,6 +1960,8 @@ static int init_socket( struct sock *sock, int family, int type, int protocol )
         {
             const int val = 1;
 
+            sock->icmp_over_dgram = 1;
+
             if (unix_family == AF_INET6)
             {
 #ifdef IPV6_RECVPKTINFO
@@ -3627,11 +3632,15 @@ static void poll_socket( struct sock *poll_sock, struct async *async, int exclus
             free( req );
             return;
         }
+        req->sockets[i].req = req;
         req->sockets[i].handle = sockets[i].socket;
         req->sockets[i].mask = sockets[i].flags;
         req->sockets[i].flags = 0;
     }
 
+    for (i = 0; i < count; ++i)
+        list_add_tail( &req->sockets[i].sock->poll_sockets, &req->sockets[i].entry );
+
     req->exclusive = exclusive;
     req->count = count;
     req->async = (struct async *)grab_object( async );
@@ -4039,6 +4048,7 @@ DECL_HANDLER(recv_socket)
         reply->wait = async_handoff( async, NULL, 0 );
         reply->options = get_fd_options( fd );
         reply->nonblocking = sock->nonblocking;
+        reply->icmp_over_dgram = sock->icmp_over_dgram;
         release_object( async );
     }
     release_object( sock );
@@ -4164,6 +4174,8 @@ DECL_HANDLER(send_socket)
         reply->wait = async_handoff( async, NULL, 0 );
         reply->options = get_fd_options( fd );
         reply->nonblocking = sock->nonblocking;
+        reply->type = sock->type;
+        reply->icmp_over_dgram = sock->icmp_over_dgram;
         release_object( async );
     }
     release_object( sock );